@@ -0,0 +1,175 @@
+/**
+ * @file Alfabetos.h
+ * @brief Alfabetos de rotor conocidos en tiempo de compilación
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ *
+ * Cada alfabeto es una clase sin estado con:
+ * - TAMANIO: número de símbolos (módulo de las rotaciones).
+ * - indice(c): posición del byte c en el alfabeto, o -1 si no pertenece.
+ * - simbolo(i): símbolo en la posición i.
+ *
+ * Con ellos RotorFijo calcula sus tablas al compilar y cada traducción se
+ * reduce a sumar el desplazamiento y restar el módulo si se pasa. Los
+ * alfabetos que solo se conocen al ejecutar los maneja RotorDeMapeo, que
+ * recurre a RotorFijo solo cuando no hay kernel vectorial para el alfabeto
+ * (ver RotorDeMapeo).
+ */
+
+#ifndef ALFABETOS_H
+#define ALFABETOS_H
+
+#include <cstddef>
+
+/**
+ * @struct AlfabetoPrt7
+ * @brief A-Z y espacio (27 símbolos), el del protocolo original
+ */
+struct AlfabetoPrt7 {
+    static constexpr int TAMANIO = 27;
+    static constexpr int indice(int c) {
+        return (c >= 'A' && c <= 'Z') ? c - 'A' : (c == ' ' ? 26 : -1);
+    }
+    static constexpr char simbolo(int i) { return i < 26 ? (char)('A' + i) : ' '; }
+};
+
+/**
+ * @struct AlfabetoDigitos
+ * @brief 0-9 (10 símbolos)
+ */
+struct AlfabetoDigitos {
+    static constexpr int TAMANIO = 10;
+    static constexpr int indice(int c) { return (c >= '0' && c <= '9') ? c - '0' : -1; }
+    static constexpr char simbolo(int i) { return (char)('0' + i); }
+};
+
+/**
+ * @struct AlfabetoMinusculas
+ * @brief a-z y espacio (27 símbolos)
+ */
+struct AlfabetoMinusculas {
+    static constexpr int TAMANIO = 27;
+    static constexpr int indice(int c) {
+        return (c >= 'a' && c <= 'z') ? c - 'a' : (c == ' ' ? 26 : -1);
+    }
+    static constexpr char simbolo(int i) { return i < 26 ? (char)('a' + i) : ' '; }
+};
+
+/**
+ * @struct AlfabetoBytes
+ * @brief Los 256 valores de un byte, en orden (rotar es sumar módulo 256)
+ */
+struct AlfabetoBytes {
+    static constexpr int TAMANIO = 256;
+    static constexpr int indice(int c) { return c; }
+    static constexpr char simbolo(int i) { return (char)(unsigned char)i; }
+};
+
+/// Secuencia 0, 1, ..., N-1 para expandir tablas al compilar
+template <int... I> struct SecuenciaIndices {};
+
+template <int N, int... I>
+struct GenerarIndices : GenerarIndices<N - 1, N - 1, I...> {};
+
+template <int... I>
+struct GenerarIndices<0, I...> {
+    typedef SecuenciaIndices<I...> tipo;
+};
+
+/**
+ * @struct TablaIndices
+ * @brief Posición de cada byte en el alfabeto A (-1 si no pertenece)
+ */
+template <class A, class S = typename GenerarIndices<256>::tipo>
+struct TablaIndices;
+
+template <class A, int... I>
+struct TablaIndices<A, SecuenciaIndices<I...> > {
+    static constexpr short valores[256] = { (short)A::indice(I)... };
+};
+
+template <class A, int... I>
+constexpr short TablaIndices<A, SecuenciaIndices<I...> >::valores[256];
+
+/**
+ * @struct TablaSimbolos
+ * @brief Símbolos del alfabeto A en orden
+ */
+template <class A, class S = typename GenerarIndices<A::TAMANIO>::tipo>
+struct TablaSimbolos;
+
+template <class A, int... I>
+struct TablaSimbolos<A, SecuenciaIndices<I...> > {
+    static constexpr char valores[sizeof...(I)] = { A::simbolo(I)... };
+};
+
+template <class A, int... I>
+constexpr char TablaSimbolos<A, SecuenciaIndices<I...> >::valores[sizeof...(I)];
+
+/**
+ * @class RotorFijo
+ * @brief Rotor cuyo alfabeto se fija al compilar
+ * @tparam A Alfabeto (AlfabetoPrt7, AlfabetoDigitos, ...)
+ *
+ * Mismo resultado que un RotorDeMapeo con los símbolos de A, pero sin
+ * nodos ni tablas en el heap: el estado es solo el desplazamiento y el
+ * módulo es una constante.
+ */
+template <class A>
+class RotorFijo {
+    int desplazamiento;     ///< Rotación neta, en [0, TAMANIO)
+
+public:
+    static constexpr int TAMANIO = A::TAMANIO;
+
+    RotorFijo() : desplazamiento(0) {}
+
+    /**
+     * @brief Rota el rotor N posiciones (positivo=derecha, negativo=izquierda)
+     */
+    void rotar(int n) { desplazamiento = (desplazamiento + n % TAMANIO + TAMANIO) % TAMANIO; }
+
+    /**
+     * @brief Vuelve el rotor a su posición inicial
+     */
+    void reiniciar() { desplazamiento = 0; }
+
+    int getDesplazamiento() const { return desplazamiento; }
+
+    /**
+     * @brief Traduce un byte con un desplazamiento dado
+     * @return El símbolo a 'desplazamiento' posiciones, o c si no pertenece a A
+     */
+    static char mapear(char c, int desplazamiento) {
+        int i = TablaIndices<A>::valores[(unsigned char)c];
+        if (i < 0) return c;
+        i += desplazamiento;
+        i -= i >= TAMANIO ? TAMANIO : 0;
+        return TablaSimbolos<A>::valores[i];
+    }
+
+    /**
+     * @brief Traduce un bloque con un desplazamiento dado
+     * @param salida Puede ser igual a 'entrada'
+     */
+    static void mapearCon(const char* entrada, char* salida, size_t n, int desplazamiento) {
+        for (size_t i = 0; i < n; i++) salida[i] = mapear(entrada[i], desplazamiento);
+    }
+
+    char getMapeo(char entrada) const { return mapear(entrada, desplazamiento); }
+
+    void mapearBloque(const char* entrada, char* salida, size_t n) const {
+        mapearCon(entrada, salida, n, desplazamiento);
+    }
+};
+
+template <class A>
+constexpr int RotorFijo<A>::TAMANIO;
+
+/// Con los 256 bytes no hacen falta tablas: el módulo es el del propio byte
+template <>
+inline char RotorFijo<AlfabetoBytes>::mapear(char c, int desplazamiento) {
+    return (char)(unsigned char)((unsigned char)c + desplazamiento);
+}
+
+#endif // ALFABETOS_H
@@ -0,0 +1,114 @@
+/**
+ * @file ArchivoMapeado.cpp
+ * @brief Implementación de ArchivoMapeado con soporte multiplataforma
+ */
+
+#include "ArchivoMapeado.h"
+#include <iostream>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+ArchivoMapeado::ArchivoMapeado()
+    : datos(0), tamanio(0), handleArchivo(0), handleMapeo(0) {}
+
+ArchivoMapeado::~ArchivoMapeado() {
+    cerrar();
+}
+
+bool ArchivoMapeado::abrir(const char* ruta) {
+    cerrar();
+    
+#ifdef _WIN32
+    HANDLE hArchivo = CreateFileA(ruta, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hArchivo == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: No se pudo abrir el archivo " << ruta << std::endl;
+        return false;
+    }
+    
+    LARGE_INTEGER tam;
+    if (!GetFileSizeEx(hArchivo, &tam)) {
+        std::cerr << "Error: No se pudo obtener el tamano de " << ruta << std::endl;
+        CloseHandle(hArchivo);
+        return false;
+    }
+    
+    handleArchivo = hArchivo;
+    tamanio = (size_t)tam.QuadPart;
+    if (tamanio == 0) return true;  // No se puede proyectar un archivo vacío
+    
+    HANDLE hMapeo = CreateFileMappingA(hArchivo, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!hMapeo) {
+        std::cerr << "Error: No se pudo proyectar " << ruta << std::endl;
+        cerrar();
+        return false;
+    }
+    handleMapeo = hMapeo;
+    
+    datos = (const char*)MapViewOfFile(hMapeo, FILE_MAP_READ, 0, 0, 0);
+    if (!datos) {
+        std::cerr << "Error: No se pudo proyectar " << ruta << std::endl;
+        cerrar();
+        return false;
+    }
+    return true;
+    
+#else
+    int fd = open(ruta, O_RDONLY);
+    if (fd == -1) {
+        std::cerr << "Error: No se pudo abrir el archivo " << ruta << std::endl;
+        return false;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::cerr << "Error: No se pudo obtener el tamano de " << ruta << std::endl;
+        close(fd);
+        return false;
+    }
+    
+    tamanio = (size_t)info.st_size;
+    if (tamanio == 0) {
+        // No se puede proyectar un archivo vacío
+        close(fd);
+        return true;
+    }
+    
+    void* proyeccion = mmap(0, tamanio, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // La proyección sigue siendo válida sin el descriptor
+    
+    if (proyeccion == MAP_FAILED) {
+        std::cerr << "Error: No se pudo proyectar " << ruta << std::endl;
+        tamanio = 0;
+        return false;
+    }
+    
+    // Se recorre de principio a fin: pedir lectura anticipada agresiva
+    madvise(proyeccion, tamanio, MADV_SEQUENTIAL);
+    
+    datos = (const char*)proyeccion;
+    return true;
+#endif
+}
+
+void ArchivoMapeado::cerrar() {
+#ifdef _WIN32
+    if (datos) UnmapViewOfFile(datos);
+    if (handleMapeo) CloseHandle((HANDLE)handleMapeo);
+    if (handleArchivo) CloseHandle((HANDLE)handleArchivo);
+#else
+    if (datos) munmap((void*)datos, tamanio);
+#endif
+    
+    datos = 0;
+    tamanio = 0;
+    handleArchivo = 0;
+    handleMapeo = 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file ArchivoMapeado.h
+ * @brief Archivo de captura proyectado en memoria para decodificación offline
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef ARCHIVO_MAPEADO_H
+#define ARCHIVO_MAPEADO_H
+
+#include <cstddef>
+
+/**
+ * @class ArchivoMapeado
+ * @brief Proyecta un archivo completo en memoria de solo lectura
+ * 
+ * Permite recorrer capturas grandes sin copiarlas a buffers intermedios:
+ * las líneas se leen directamente de la proyección. En Linux/Mac usa
+ * mmap(); en Windows, CreateFileMapping/MapViewOfFile.
+ */
+class ArchivoMapeado {
+private:
+    const char* datos;      ///< Inicio de la proyección (0 si no hay archivo abierto)
+    size_t tamanio;         ///< Tamaño del archivo en bytes
+    void* handleArchivo;    ///< Handle del archivo (solo Windows)
+    void* handleMapeo;      ///< Handle de la proyección (solo Windows)
+    
+    // No se permite copiar: la proyección se libera en el destructor
+    ArchivoMapeado(const ArchivoMapeado&);
+    ArchivoMapeado& operator=(const ArchivoMapeado&);
+    
+public:
+    /**
+     * @brief Constructor que deja el objeto sin archivo
+     */
+    ArchivoMapeado();
+    
+    /**
+     * @brief Destructor que libera la proyección
+     */
+    ~ArchivoMapeado();
+    
+    /**
+     * @brief Abre y proyecta un archivo
+     * @param ruta Ruta del archivo de captura
+     * @return true si se proyectó correctamente, false en caso contrario
+     */
+    bool abrir(const char* ruta);
+    
+    /**
+     * @brief Libera la proyección y cierra el archivo
+     */
+    void cerrar();
+    
+    /**
+     * @brief Obtiene el contenido del archivo
+     * @return Puntero al primer byte (válido hasta cerrar())
+     */
+    const char* getDatos() const { return datos; }
+    
+    /**
+     * @brief Obtiene el tamaño del archivo
+     * @return Número de bytes proyectados
+     */
+    size_t getTamanio() const { return tamanio; }
+};
+
+#endif // ARCHIVO_MAPEADO_H
@@ -0,0 +1,81 @@
+/**
+ * @file ArenaTrama.h
+ * @brief Almacenamiento reutilizable para construir tramas sin usar el heap
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef ARENA_TRAMA_H
+#define ARENA_TRAMA_H
+
+#include "TramaBase.h"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/**
+ * @class ArenaTrama
+ * @brief Espacio fijo donde se construye la trama en curso
+ * 
+ * El bucle principal procesa una trama a la vez, así que basta un solo
+ * espacio reutilizable: construir() destruye la trama anterior y crea la
+ * nueva en el mismo lugar con placement new. Así se evitan dos llamadas
+ * al asignador de memoria por trama y se conserva la interfaz polimórfica
+ * de TramaBase para cualquier tipo de trama que quepa en TAM_MAXIMO.
+ * 
+ * La trama devuelta pertenece a la arena: no debe liberarse con delete y
+ * deja de ser válida en la siguiente llamada a construir() o liberar().
+ */
+class ArenaTrama {
+public:
+    static const size_t TAM_MAXIMO = 32;    ///< Tamaño máximo de una trama derivada
+    
+private:
+    /// Memoria alineada para cualquier clase derivada de TramaBase
+    std::aligned_storage<TAM_MAXIMO, alignof(std::max_align_t)>::type almacen;
+    TramaBase* actual;      ///< Trama construida en 'almacen', o 0 si está vacía
+    
+    // No se permite copiar: la trama vive dentro de 'almacen'
+    ArenaTrama(const ArenaTrama&);
+    ArenaTrama& operator=(const ArenaTrama&);
+    
+public:
+    /**
+     * @brief Constructor que deja la arena vacía
+     */
+    ArenaTrama() : actual(0) {}
+    
+    /**
+     * @brief Destructor que destruye la trama que quede en la arena
+     */
+    ~ArenaTrama() { liberar(); }
+    
+    /**
+     * @brief Construye una trama en la arena, reemplazando la anterior
+     * @tparam T Tipo concreto de trama (ej. TramaLoad, TramaMap)
+     * @param args Argumentos para el constructor de T
+     * @return Puntero a la trama construida (propiedad de la arena)
+     */
+    template <class T, class... Args>
+    T* construir(Args... args) {
+        static_assert(sizeof(T) <= TAM_MAXIMO, "La trama no cabe en ArenaTrama");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Alineacion no soportada");
+        
+        liberar();
+        T* trama = new (&almacen) T(args...);
+        actual = trama;
+        return trama;
+    }
+    
+    /**
+     * @brief Destruye la trama actual (llamando a su destructor virtual)
+     */
+    void liberar() {
+        if (actual) {
+            actual->~TramaBase();
+            actual = 0;
+        }
+    }
+};
+
+#endif // ARENA_TRAMA_H
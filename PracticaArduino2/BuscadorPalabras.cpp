@@ -0,0 +1,157 @@
+/**
+ * @file BuscadorPalabras.cpp
+ * @brief Implementación del autómata de palabras vigiladas
+ */
+
+#include "BuscadorPalabras.h"
+#include <cstring>
+#include <iostream>
+
+void AvisoCoincidencias::alCoincidir(const char* palabra, size_t longitud,
+                                     unsigned long long posicion) {
+    std::cerr << "Alerta: ";
+    if (sesion) std::cerr << "[" << sesion << "] ";
+    std::cerr << "\"";
+    std::cerr.write(palabra, (std::streamsize)longitud);
+    std::cerr << "\" en la posicion " << posicion << " del mensaje" << std::endl;
+}
+
+BuscadorPalabras::BuscadorPalabras(ReceptorCoincidencias* destino)
+    : texto(new char[MAX_PALABRAS * MAX_LONGITUD]), numPalabras(0), numClases(1),
+      transiciones(0), salida(0), enlaceSalida(0), numEstados(0),
+      estado(0), coincidencias(0), receptor(destino) {
+    inicios[0] = 0;
+    std::memset(clase, 0, sizeof(clase));
+}
+
+BuscadorPalabras::~BuscadorPalabras() {
+    delete[] texto;
+    delete[] transiciones;
+    delete[] salida;
+    delete[] enlaceSalida;
+}
+
+bool BuscadorPalabras::agregarPalabra(const char* palabra, size_t longitud) {
+    if (longitud < 1 || longitud > (size_t)MAX_LONGITUD || numPalabras == MAX_PALABRAS) {
+        return false;
+    }
+
+    std::memcpy(texto + inicios[numPalabras], palabra, longitud);
+    inicios[numPalabras + 1] = inicios[numPalabras] + (int)longitud;
+    numPalabras++;
+    return true;
+}
+
+void BuscadorPalabras::compilar() {
+    delete[] transiciones;
+    delete[] salida;
+    delete[] enlaceSalida;
+
+    // Una clase por cada byte que aparece en alguna palabra
+    std::memset(clase, 0, sizeof(clase));
+    numClases = 1;
+    for (int i = 0; i < inicios[numPalabras]; i++) {
+        unsigned char c = (unsigned char)texto[i];
+        if (clase[c] == 0) clase[c] = (unsigned char)numClases++;
+    }
+
+    // Como mucho un estado por carácter, más la raíz
+    int maxEstados = inicios[numPalabras] + 1;
+    transiciones = new int[maxEstados * numClases];
+    salida = new int[maxEstados];
+    enlaceSalida = new int[maxEstados];
+    for (int i = 0; i < maxEstados * numClases; i++) transiciones[i] = -1;
+    for (int i = 0; i < maxEstados; i++) {
+        salida[i] = -1;
+        enlaceSalida[i] = -1;
+    }
+    numEstados = 1;
+
+    // Trie de las palabras
+    for (int p = 0; p < numPalabras; p++) {
+        int s = 0;
+        for (int i = inicios[p]; i < inicios[p + 1]; i++) {
+            int* t = &transiciones[s * numClases + clase[(unsigned char)texto[i]]];
+            if (*t < 0) *t = numEstados++;
+            s = *t;
+        }
+        if (salida[s] < 0) salida[s] = p;
+    }
+
+    // Enlaces de fallo por niveles; las transiciones que faltan se toman
+    // del estado de fallo, cuya fila ya está completa
+    int* fallo = new int[numEstados];
+    int* cola = new int[numEstados];
+    int primero = 0;
+    int ultimo = 0;
+
+    for (int k = 0; k < numClases; k++) {
+        int t = transiciones[k];
+        if (t < 0) {
+            transiciones[k] = 0;
+        } else {
+            fallo[t] = 0;
+            cola[ultimo++] = t;
+        }
+    }
+
+    while (primero < ultimo) {
+        int s = cola[primero++];
+        for (int k = 0; k < numClases; k++) {
+            int* t = &transiciones[s * numClases + k];
+            int siguienteFallo = transiciones[fallo[s] * numClases + k];
+            if (*t < 0) {
+                *t = siguienteFallo;
+                continue;
+            }
+            fallo[*t] = siguienteFallo;
+            enlaceSalida[*t] = salida[siguienteFallo] >= 0 ? siguienteFallo
+                                                           : enlaceSalida[siguienteFallo];
+            cola[ultimo++] = *t;
+        }
+    }
+
+    delete[] fallo;
+    delete[] cola;
+
+    // Cada transición guarda el inicio de la fila destino, con el bit 0 a 1
+    // si ese estado tiene algo que reportar: avanzar no multiplica
+    for (int i = 0; i < numEstados * numClases; i++) {
+        int t = transiciones[i];
+        bool reporta = salida[t] >= 0 || enlaceSalida[t] >= 0;
+        transiciones[i] = (t * numClases) << 1 | (reporta ? 1 : 0);
+    }
+    estado = 0;
+}
+
+void BuscadorPalabras::procesar(const char* datos, size_t n, unsigned long long posicion) {
+    if (!transiciones) return;
+
+    int fila = estado * numClases;
+    for (size_t i = 0; i < n; i++) {
+        int t = transiciones[fila + clase[(unsigned char)datos[i]]];
+        fila = t >> 1;
+        if (t & 1) reportar(fila / numClases, posicion + i);
+    }
+    estado = fila / numClases;
+}
+
+void BuscadorPalabras::sincronizar(const char* datos, size_t n) {
+    if (!transiciones) return;
+
+    int fila = 0;
+    for (size_t i = 0; i < n; i++) fila = transiciones[fila + clase[(unsigned char)datos[i]]] >> 1;
+    estado = fila / numClases;
+}
+
+void BuscadorPalabras::reportar(int s, unsigned long long fin) {
+    // La palabra propia del estado y luego las que son sufijo de ella
+    int t = salida[s] >= 0 ? s : enlaceSalida[s];
+    while (t >= 0) {
+        int p = salida[t];
+        size_t longitud = (size_t)(inicios[p + 1] - inicios[p]);
+        coincidencias++;
+        if (receptor) receptor->alCoincidir(texto + inicios[p], longitud, fin + 1 - longitud);
+        t = enlaceSalida[t];
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @file BuscadorPalabras.h
+ * @brief Búsqueda incremental de palabras vigiladas en el mensaje (Aho-Corasick)
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef BUSCADOR_PALABRAS_H
+#define BUSCADOR_PALABRAS_H
+
+#include <cstddef>
+
+/**
+ * @class ReceptorCoincidencias
+ * @brief Destino de las apariciones encontradas por BuscadorPalabras
+ */
+class ReceptorCoincidencias {
+public:
+    /**
+     * @brief Destructor virtual para uso polimórfico
+     */
+    virtual ~ReceptorCoincidencias() {}
+
+    /**
+     * @brief Se llama por cada aparición, en el orden en que terminan
+     * @param palabra Palabra encontrada (sin terminador)
+     * @param longitud Bytes de la palabra
+     * @param posicion Posición de su primer carácter en el mensaje (desde 0)
+     */
+    virtual void alCoincidir(const char* palabra, size_t longitud,
+                             unsigned long long posicion) = 0;
+};
+
+/**
+ * @class AvisoCoincidencias
+ * @brief Imprime cada aparición en stderr como una alerta
+ */
+class AvisoCoincidencias : public ReceptorCoincidencias {
+    const char* sesion;     ///< Nombre de la sesión para el aviso, o 0
+
+public:
+    /**
+     * @brief Constructor
+     * @param nombre Sesión que se antepone al aviso (0 = ninguna)
+     */
+    explicit AvisoCoincidencias(const char* nombre = 0) : sesion(nombre) {}
+
+    void alCoincidir(const char* palabra, size_t longitud, unsigned long long posicion);
+};
+
+/**
+ * @class BuscadorPalabras
+ * @brief Autómata de Aho-Corasick sobre una lista de palabras vigiladas
+ *
+ * Recibe el mensaje a medida que se anexa (ver ListaDeCarga::setBuscador())
+ * y avisa de cada aparición de cualquier palabra en O(1) por carácter, sin
+ * volver a recorrer lo ya recibido. Las palabras se agregan primero y se
+ * compilan una vez; la transición de cada estado está completa, así que
+ * avanzar es un único acceso a la tabla. Para que la tabla sea pequeña los
+ * bytes se agrupan en clases: los que no aparecen en ninguna palabra
+ * comparten la clase 0.
+ *
+ * Cada mensaje se busca por separado: reiniciar() (al vaciar la lista)
+ * vuelve al estado inicial.
+ */
+class BuscadorPalabras {
+public:
+    static const int MAX_PALABRAS = 64;     ///< Palabras vigiladas como máximo
+    static const int MAX_LONGITUD = 256;    ///< Bytes máximos por palabra
+
+private:
+    char* texto;                ///< Palabras agregadas, una tras otra
+    int inicios[MAX_PALABRAS + 1]; ///< Palabra i en texto[inicios[i]] .. texto[inicios[i + 1]]
+    int numPalabras;            ///< Palabras agregadas
+
+    unsigned char clase[256];   ///< Clase de cada byte (0 = fuera de toda palabra)
+    int numClases;              ///< Clases distintas, incluida la 0
+    int* transiciones;          ///< Por estado y clase: fila siguiente * 2 + (1 si reporta)
+    int* salida;                ///< Palabra que termina en cada estado, o -1
+    int* enlaceSalida;          ///< Estado sufijo más largo con salida, o -1
+    int numEstados;             ///< Estados del autómata (0 = raíz)
+
+    int estado;                 ///< Estado actual
+    unsigned long long coincidencias; ///< Apariciones reportadas
+    ReceptorCoincidencias* receptor;  ///< Destino de las apariciones, o 0
+
+    /**
+     * @brief Reporta las palabras que terminan en el estado s
+     * @param s Estado con salida propia o enlace de salida
+     * @param fin Posición en el mensaje del último carácter leído
+     */
+    void reportar(int s, unsigned long long fin);
+
+    // No se permite copiar: contiene las tablas del autómata
+    BuscadorPalabras(const BuscadorPalabras&);
+    BuscadorPalabras& operator=(const BuscadorPalabras&);
+
+public:
+    /**
+     * @brief Constructor que deja el buscador sin palabras
+     * @param destino Receptor de las apariciones (no pasa a ser propiedad)
+     */
+    explicit BuscadorPalabras(ReceptorCoincidencias* destino = 0);
+
+    /**
+     * @brief Destructor que libera las tablas
+     */
+    ~BuscadorPalabras();
+
+    /**
+     * @brief Agrega una palabra a vigilar (antes de compilar())
+     * @param palabra Bytes de la palabra
+     * @param longitud Bytes (1 a MAX_LONGITUD)
+     * @return false si la longitud no es válida o ya hay MAX_PALABRAS;
+     *         una palabra repetida se acepta pero se vigila una vez
+     */
+    bool agregarPalabra(const char* palabra, size_t longitud);
+
+    /**
+     * @brief Construye el autómata con las palabras agregadas
+     */
+    void compilar();
+
+    /**
+     * @brief Avanza el autómata con caracteres recién anexados al mensaje
+     * @param datos Caracteres decodificados, en orden
+     * @param n Número de caracteres
+     * @param posicion Posición de datos[0] en el mensaje
+     */
+    void procesar(const char* datos, size_t n, unsigned long long posicion);
+
+    /**
+     * @brief Deja el autómata como si hubiera leído 'datos', sin reportar nada
+     * @param datos Final del mensaje ya recibido (bastan MAX_LONGITUD - 1 bytes)
+     * @param n Número de caracteres
+     *
+     * Permite seguir buscando un mensaje restaurado sin repetir los avisos
+     * de lo que ya se había revisado.
+     */
+    void sincronizar(const char* datos, size_t n);
+
+    /**
+     * @brief Vuelve al estado inicial (empieza un mensaje nuevo)
+     */
+    void reiniciar() { estado = 0; }
+
+    /**
+     * @brief Elige el receptor de las apariciones
+     * @param destino Receptor (0 = solo contarlas)
+     */
+    void setReceptor(ReceptorCoincidencias* destino) { receptor = destino; }
+
+    /**
+     * @brief Apariciones reportadas desde la construcción
+     * @return Número de coincidencias
+     */
+    unsigned long long getCoincidencias() const { return coincidencias; }
+
+    /**
+     * @brief Palabras distintas vigiladas
+     * @return Número de palabras
+     */
+    int getNumPalabras() const { return numPalabras; }
+};
+
+#endif // BUSCADOR_PALABRAS_H
@@ -0,0 +1,264 @@
+/**
+ * @file ColaSPSC.h
+ * @brief Cola acotada sin bloqueos para un productor y un consumidor
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef COLA_SPSC_H
+#define COLA_SPSC_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class ColaSPSC
+ * @brief Anillo de N casillas compartido entre exactamente dos hilos
+ * @tparam T Tipo de cada casilla (se reutiliza, no se construye por elemento)
+ * @tparam N Número de casillas (potencia de 2)
+ *
+ * El productor pide una casilla libre con reservar(), la rellena en sitio y
+ * la entrega con publicar(); el consumidor la toma con frente() y la
+ * devuelve con liberar(). Cada índice lo escribe un solo hilo, así que basta
+ * un par acquire/release por operación y no hace falta ningún mutex.
+ *
+ * esperarReserva() y esperarFrente() insisten unas pocas vueltas y después
+ * se bloquean en una variable de condición; el otro lado solo toma el mutex
+ * para despertarlos cuando de verdad hay alguien dormido, así que el camino
+ * con datos sigue sin bloqueos y un hilo inactivo no consume procesador.
+ *
+ * Los contadores de presión indican qué lado espera al otro: si la cola se
+ * llena a menudo, la etapa lenta es la consumidora; si se vacía mientras el
+ * productor tiene datos en curso (ver setProductorActivo()), la lenta es la
+ * productora. Las esperas con el productor inactivo (enlace sin tráfico) no
+ * cuentan.
+ */
+template <class T, size_t N>
+class ColaSPSC {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N debe ser potencia de 2");
+
+    /// Separa los campos de cada hilo en líneas de caché distintas
+    static const size_t LINEA_CACHE = 64;
+
+    /// Comprobaciones antes de dormir en esperarReserva()/esperarFrente()
+    static const int VUELTAS_ANTES_DE_DORMIR = 64;
+
+    // Lado del productor
+    std::atomic<size_t> escritura;              ///< Casillas publicadas
+    std::atomic<unsigned long> vecesLlena;      ///< Esperas del productor con la cola llena
+    std::atomic<size_t> ocupacionMaxima;        ///< Mayor número de casillas en uso observado
+    std::atomic<bool> productorActivo;          ///< El productor tiene datos en curso
+    std::atomic<bool> cerrada;                  ///< El productor no publicará más
+    char rellenoProductor[LINEA_CACHE];
+
+    // Lado del consumidor
+    std::atomic<size_t> lectura;                ///< Casillas liberadas
+    std::atomic<unsigned long> vecesVacia;      ///< Esperas del consumidor con el productor activo
+    char rellenoConsumidor[LINEA_CACHE];
+
+    // Esperas bloqueantes
+    std::mutex cerrojo;                         ///< Protege solo el paso a dormir
+    std::condition_variable despertar;          ///< Avisa de un cambio a quien duerma
+    std::atomic<bool> productorDormido;         ///< El productor espera una casilla libre
+    std::atomic<bool> consumidorDormido;        ///< El consumidor espera una casilla publicada
+
+    T casillas[N];          ///< Almacenamiento de los elementos
+
+    // No se permite copiar: la comparten dos hilos
+    ColaSPSC(const ColaSPSC&);
+    ColaSPSC& operator=(const ColaSPSC&);
+
+    /**
+     * @brief Despierta al otro hilo si está dormido en la cola
+     * @param dormido Indicador del hilo a despertar
+     *
+     * La barrera ordena el índice recién publicado antes de leer el
+     * indicador; el hilo que se duerme hace lo mismo en orden inverso, así
+     * que uno de los dos ve siempre al otro.
+     */
+    void avisar(std::atomic<bool>& dormido) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (dormido.load(std::memory_order_relaxed)) {
+            { std::lock_guard<std::mutex> bloqueo(cerrojo); }
+            despertar.notify_all();
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor que deja la cola vacía
+     */
+    ColaSPSC() : escritura(0), vecesLlena(0), ocupacionMaxima(0),
+                 productorActivo(false), cerrada(false),
+                 lectura(0), vecesVacia(0),
+                 productorDormido(false), consumidorDormido(false) {}
+
+    /**
+     * @brief (Productor) Obtiene la siguiente casilla libre
+     * @return Casilla a rellenar, o 0 si la cola está llena
+     */
+    T* reservar() {
+        size_t w = escritura.load(std::memory_order_relaxed);
+        size_t r = lectura.load(std::memory_order_acquire);
+        if (w - r == N) return 0;
+        if (w - r + 1 > ocupacionMaxima.load(std::memory_order_relaxed)) {
+            ocupacionMaxima.store(w - r + 1, std::memory_order_relaxed);
+        }
+        return &casillas[w & (N - 1)];
+    }
+
+    /**
+     * @brief (Productor) Como reservar(), pero espera a que haya casilla libre
+     * @return Casilla a rellenar
+     *
+     * Cada espera cuenta una vez en getVecesLlena().
+     */
+    T* esperarReserva() {
+        T* casilla = reservar();
+        if (casilla) return casilla;
+        vecesLlena.store(vecesLlena.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+
+        for (int i = 0; i < VUELTAS_ANTES_DE_DORMIR; i++) {
+            std::this_thread::yield();
+            if ((casilla = reservar())) return casilla;
+        }
+
+        std::unique_lock<std::mutex> bloqueo(cerrojo);
+        productorDormido.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!(casilla = reservar())) despertar.wait(bloqueo);
+        productorDormido.store(false, std::memory_order_relaxed);
+        return casilla;
+    }
+
+    /**
+     * @brief (Productor) Entrega la casilla obtenida con reservar()
+     */
+    void publicar() {
+        escritura.store(escritura.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+        avisar(consumidorDormido);
+    }
+
+    /**
+     * @brief (Productor) Indica si hay datos en curso hacia la cola
+     * @param activo true mientras el productor trabaja en algo que acabará
+     *        publicando; false antes de esperar a su propia entrada
+     *
+     * Solo las esperas del consumidor con el productor activo cuentan en
+     * getVecesVacia(): así el contador mide cuánto frena la etapa anterior
+     * y no el tiempo que el enlace pasa sin tráfico.
+     */
+    void setProductorActivo(bool activo) {
+        productorActivo.store(activo, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief (Productor) Anuncia que no se publicará nada más
+     *
+     * Despierta al consumidor para que esperarFrente() devuelva 0 en cuanto
+     * la cola quede vacía.
+     */
+    void cerrar() {
+        productorActivo.store(false, std::memory_order_relaxed);
+        cerrada.store(true, std::memory_order_release);
+        avisar(consumidorDormido);
+    }
+
+    /**
+     * @brief (Consumidor) Obtiene la casilla publicada más antigua
+     * @return Casilla a consumir, o 0 si la cola está vacía
+     */
+    T* frente() {
+        size_t r = lectura.load(std::memory_order_relaxed);
+        if (escritura.load(std::memory_order_acquire) == r) return 0;
+        return &casillas[r & (N - 1)];
+    }
+
+    /**
+     * @brief (Consumidor) Como frente(), pero espera a que se publique algo
+     * @param timeoutMs Espera máxima dormido (negativo = sin límite)
+     * @return Casilla a consumir, o 0 si se agotó la espera o la cola está
+     *         cerrada y vacía (ver terminada())
+     *
+     * Cada espera con el productor activo cuenta una vez en getVecesVacia().
+     */
+    T* esperarFrente(int timeoutMs) {
+        T* casilla = frente();
+        if (casilla || terminada()) return casilla;
+        if (productorActivo.load(std::memory_order_relaxed)) {
+            vecesVacia.store(vecesVacia.load(std::memory_order_relaxed) + 1,
+                             std::memory_order_relaxed);
+        }
+
+        for (int i = 0; i < VUELTAS_ANTES_DE_DORMIR; i++) {
+            std::this_thread::yield();
+            if ((casilla = frente()) || terminada()) return casilla;
+        }
+
+        std::unique_lock<std::mutex> bloqueo(cerrojo);
+        consumidorDormido.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::chrono::steady_clock::time_point limite =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs < 0 ? 0 : timeoutMs);
+        while (!(casilla = frente()) && !terminada()) {
+            if (timeoutMs < 0) {
+                despertar.wait(bloqueo);
+            } else if (despertar.wait_until(bloqueo, limite) == std::cv_status::timeout) {
+                casilla = frente();
+                break;
+            }
+        }
+        consumidorDormido.store(false, std::memory_order_relaxed);
+        return casilla;
+    }
+
+    /**
+     * @brief (Consumidor) Indica si la cola está cerrada y ya no queda nada
+     */
+    bool terminada() const {
+        return cerrada.load(std::memory_order_acquire) &&
+               escritura.load(std::memory_order_acquire) == lectura.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief (Consumidor) Devuelve al productor la casilla obtenida con frente()
+     */
+    void liberar() {
+        lectura.store(lectura.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_release);
+        avisar(productorDormido);
+    }
+
+    /**
+     * @brief Número de casillas de la cola
+     */
+    static size_t capacidad() { return N; }
+
+    /**
+     * @brief Veces que el productor esperó con la cola llena (consumidor lento)
+     */
+    unsigned long getVecesLlena() const { return vecesLlena.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Veces que el consumidor esperó con el productor activo (productor lento)
+     */
+    unsigned long getVecesVacia() const { return vecesVacia.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Mayor ocupación observada por el productor
+     */
+    size_t getOcupacionMaxima() const { return ocupacionMaxima.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Casillas publicadas en total
+     */
+    unsigned long long getPublicadas() const { return escritura.load(std::memory_order_relaxed); }
+};
+
+#endif // COLA_SPSC_H
@@ -0,0 +1,216 @@
+/**
+ * @file Decodificador.cpp
+ * @brief Implementación del núcleo de decodificación
+ */
+
+#include "Decodificador.h"
+#include "TramaBase.h"
+#include "TramaLoad.h"
+#include "TramaMap.h"
+#include "TramaFin.h"
+#include "TramaLote.h"
+#include <cstring>
+#include <iostream>
+
+Decodificador::Decodificador(int capacidadBloque, const char* alfabeto, int longitudAlfabeto)
+    : lista(capacidadBloque), rotor(alfabeto, longitudAlfabeto), enLote(0), tramasRecibidas(0),
+      erroresParseo(0), reportarErrores(true), reiniciarRotorEnFin(false),
+      mensajesCompletos(0), metricas(0), llegada(0), rotacionPendiente(0) {}
+
+void Decodificador::procesarLinea(const char* linea, size_t longitud,
+                                  unsigned long long offset) {
+    if (metricas) {
+        procesarLineaMedida(linea, longitud, offset);
+        return;
+    }
+    
+    TramaParseada trama;
+    ErrorParseo error = parsearLinea(linea, longitud, trama);
+    
+    if (error == PARSEO_OK) {
+        alRecibirTrama(trama, linea, longitud, offset);
+    } else {
+        alErrorParseo(error, linea, longitud, offset);
+    }
+}
+
+void Decodificador::procesarLineaMedida(const char* linea, size_t longitud,
+                                        unsigned long long offset) {
+    long long inicio = relojNs();
+    if (llegada) metricas->espera.registrar(inicio - llegada);
+    
+    TramaParseada trama;
+    ErrorParseo error = parsearLinea(linea, longitud, trama);
+    metricas->parseo.registrar(relojNs() - inicio);
+    
+    if (error == PARSEO_OK) {
+        alRecibirTrama(trama, linea, longitud, offset);
+    } else {
+        alErrorParseo(error, linea, longitud, offset);
+    }
+}
+
+void Decodificador::alRecibirTrama(const TramaParseada& trama, const char* linea,
+                                   size_t longitud, unsigned long long offset) {
+    tramasRecibidas++;
+    
+    // Sin lectura de puerto (ej. --input) la latencia se mide desde aquí
+    long long inicio = 0;
+    if (metricas) {
+        inicio = llegada ? llegada : relojNs();
+        metricas->lineas++;
+        metricas->bytes = offset + longitud;
+    }
+    
+    if (trama.tipo == TRAMA_CARGA) {
+        // Acumular: se decodifica junto con las cargas vecinas
+        if (metricas) {
+            metricas->cargas++;
+            llegadasLote[enLote] = inicio;
+        }
+        // El diagnóstico repite la línea tal como llegó ("L,X" o "L,Space")
+        if (TramaBase::getModoSalida() != SALIDA_SILENCIOSA) {
+            size_t largo = longitud < sizeof(lineasLote[0]) ? longitud : sizeof(lineasLote[0]);
+            std::memcpy(lineasLote[enLote], linea, largo);
+            largosLote[enLote] = (unsigned char)largo;
+        }
+        lote[enLote++] = trama.caracter;
+        if (enLote == TAM_LOTE) vaciarLote();
+        return;
+    }
+    
+    bool silencioso = TramaBase::getModoSalida() == SALIDA_SILENCIOSA;
+    if (silencioso && trama.tipo == TRAMA_MAPEO) {
+        // Sin diagnóstico por trama, los MAP seguidos solo se suman: el
+        // rotor gira una vez, al vaciar el lote de la siguiente racha
+        long long antes = metricas ? relojNs() : 0;
+        if (enLote > 0) vaciarLote();
+        int tamanio = rotor.getTamanio();
+        if (tamanio > 0) {
+            rotacionPendiente = (rotacionPendiente + trama.rotacion % tamanio) % tamanio;
+        }
+        if (metricas) {
+            long long despues = relojNs();
+            metricas->mapeos++;
+            metricas->procesar.registrar(despues - antes);
+            metricas->total.registrar(despues - inicio);
+        }
+        return;
+    }
+    
+    // Cualquier otra trama cierra el lote antes de procesarse
+    vaciarLote();
+    
+    if (!silencioso) {
+        std::cout << "Trama recibida: [";
+        std::cout.write(linea, longitud);
+        std::cout << "] -> Procesando... -> ";
+    }
+    
+    // Ejecutar el procesamiento polimórfico
+    long long antes = metricas ? relojNs() : 0;
+    if (trama.tipo == TRAMA_FIN) {
+        finalizarMensaje();
+    } else {
+        TramaBase* procesable = arena.construir<TramaMap>(trama.rotacion);
+        procesable->procesar(&lista, &rotor);
+    }
+    if (metricas) {
+        long long despues = relojNs();
+        if (trama.tipo == TRAMA_FIN) {
+            metricas->fines++;
+        } else {
+            metricas->mapeos++;
+        }
+        metricas->procesar.registrar(despues - antes);
+        metricas->total.registrar(despues - inicio);
+    }
+    
+    if (!silencioso) std::cout << std::endl;
+}
+
+void Decodificador::finalizarMensaje() {
+    vaciarLote();
+    
+    TramaBase* procesable = arena.construir<TramaFin>(reiniciarRotorEnFin);
+    procesable->procesar(&lista, &rotor);
+    mensajesCompletos++;
+}
+
+void Decodificador::alErrorParseo(ErrorParseo error, const char* linea,
+                                  size_t longitud, unsigned long long offset) {
+    tramasRecibidas++;
+    erroresParseo++;
+    if (metricas) {
+        metricas->lineas++;
+        metricas->errores++;
+        metricas->bytes = offset + longitud;
+    }
+    vaciarLote();
+    if (!reportarErrores) return;
+    
+    std::cerr << "Error: " << describirError(error) << " (byte " << offset << ")" << std::endl;
+    
+    if (TramaBase::getModoSalida() != SALIDA_SILENCIOSA) {
+        std::cout << "Trama recibida: [";
+        std::cout.write(linea, longitud);
+        std::cout << "] -> Procesando... -> Error al parsear trama" << std::endl;
+        std::cout << std::endl;
+    }
+}
+
+void Decodificador::aplicarRotacion() {
+    if (rotacionPendiente == 0) return;
+    
+    TramaBase* procesable = arena.construir<TramaMap>(rotacionPendiente);
+    procesable->procesar(&lista, &rotor);
+    rotacionPendiente = 0;
+}
+
+void Decodificador::vaciarLote() {
+    // Los MAP pendientes llegaron antes que cualquier carga del lote
+    aplicarRotacion();
+    if (enLote == 0) return;
+    
+    // Entre dos tramas MAP todas las cargas usan el mismo estado del rotor,
+    // así que se traducen juntas en lugar de una llamada virtual y un
+    // getMapeo() por trama
+    long long antes = metricas ? relojNs() : 0;
+    int n = enLote;
+    enLote = 0;
+    
+    if (TramaBase::getModoSalida() == SALIDA_SILENCIOSA) {
+        // Sin diagnósticos por fragmento todo el lote es una sola trama
+        TramaBase* procesable = arena.construir<TramaLote>(lote, n);
+        procesable->procesar(&lista, &rotor);
+    } else {
+        char decodificados[TAM_LOTE];
+        rotor.mapearBloque(lote, decodificados, n);
+        reportarLote(decodificados, n);
+    }
+    
+    if (metricas) {
+        // El costo del lote se reparte entre sus cargas
+        long long despues = relojNs();
+        metricas->procesar.registrar((despues - antes) / n, (unsigned long long)n);
+        for (int i = 0; i < n; i++) metricas->total.registrar(despues - llegadasLote[i]);
+    }
+}
+
+void Decodificador::reportarLote(const char* decodificados, int n) {
+    // Misma salida que produciría TramaLoad::procesar() para cada fragmento
+    for (int i = 0; i < n; i++) {
+        lista.insertarAlFinal(decodificados[i]);
+        
+        std::cout << "Trama recibida: [";
+        std::cout.write(lineasLote[i], largosLote[i]);
+        std::cout << "] -> Procesando... -> ";
+        TramaLoad::reportar(lote[i], decodificados[i], &lista);
+        std::cout << std::endl;
+    }
+}
+
+void Decodificador::imprimirMensaje() {
+    vaciarLote();
+    lista.imprimirMensaje();
+}
@@ -0,0 +1,229 @@
+/**
+ * @file Decodificador.h
+ * @brief Núcleo de decodificación PRT-7 compartido por todas las fuentes de tramas
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef DECODIFICADOR_H
+#define DECODIFICADOR_H
+
+#include <cstddef>
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+#include "ArenaTrama.h"
+#include "ParserTramas.h"
+#include "Metricas.h"
+
+/**
+ * @class Decodificador
+ * @brief Estado de una sesión de decodificación: rotor, mensaje y lote pendiente
+ * 
+ * Recibe líneas de cualquier origen (puerto serial o captura en archivo),
+ * las parsea y ejecuta el procesamiento polimórfico de cada trama. Las
+ * cargas consecutivas se acumulan y se procesan juntas como una TramaLote.
+ * En modo silencioso, además, los MAP consecutivos se suman y el rotor
+ * gira una sola vez con la rotación neta, justo antes de la siguiente
+ * carga o FIN.
+ * 
+ * Implementa ReceptorTramas, así que un buffer completo puede pasarse
+ * directamente a tokenizarTramas().
+ */
+class Decodificador : public ReceptorTramas {
+public:
+    static const int TAM_LOTE = 256;    ///< Máximo de cargas consecutivas decodificadas juntas
+    
+private:
+    ListaDeCarga lista;     ///< Mensaje ensamblado
+    RotorDeMapeo rotor;     ///< Disco de cifrado
+    ArenaTrama arena;       ///< Espacio reutilizado para cada trama
+    char lote[TAM_LOTE];    ///< Cargas pendientes de decodificar, sin mapear
+    int enLote;             ///< Cargas en 'lote'
+    long tramasRecibidas;   ///< Líneas procesadas (válidas o no)
+    long erroresParseo;     ///< Líneas rechazadas por el parser
+    bool reportarErrores;   ///< Si alErrorParseo() imprime el diagnóstico
+    bool reiniciarRotorEnFin; ///< Si cada FIN devuelve el rotor a su posición inicial
+    long mensajesCompletos; ///< Mensajes cerrados con FIN
+    Metricas* metricas;     ///< Contadores y latencias, o 0 para no medir
+    long long llegada;      ///< Instante de lectura de la línea actual (0 = desconocido)
+    long long llegadasLote[TAM_LOTE]; ///< Instante de lectura de cada carga del lote
+    char lineasLote[TAM_LOTE][8]; ///< Texto recibido de cada carga (solo con diagnóstico)
+    unsigned char largosLote[TAM_LOTE]; ///< Bytes de cada línea de 'lineasLote'
+    int rotacionPendiente;  ///< Suma de los MAP aún no aplicados al rotor
+    
+    /**
+     * @brief Aplica al rotor la rotación acumulada de los MAP recientes
+     */
+    void aplicarRotacion();
+    
+    /**
+     * @brief procesarLinea() midiendo el parseo (solo con métricas)
+     */
+    void procesarLineaMedida(const char* linea, size_t longitud, unsigned long long offset);
+    
+    /**
+     * @brief Inserta el lote imprimiendo el diagnóstico de cada carga
+     * @param decodificados Cargas del lote ya mapeadas
+     * @param n Cargas en el lote
+     */
+    void reportarLote(const char* decodificados, int n);
+    
+    // No se permite copiar: contiene las estructuras de la sesión
+    Decodificador(const Decodificador&);
+    Decodificador& operator=(const Decodificador&);
+    
+public:
+    /**
+     * @brief Constructor que prepara una sesión vacía
+     * @param capacidadBloque Caracteres por nodo de la lista de carga
+     * @param alfabeto Símbolos del rotor (0 = A-Z y espacio), ver RotorDeMapeo
+     * @param longitudAlfabeto Número de símbolos
+     */
+    Decodificador(int capacidadBloque = 1, const char* alfabeto = 0, int longitudAlfabeto = 0);
+    
+    /**
+     * @brief Procesa una línea recibida
+     * @param linea Inicio de la línea (sin terminador)
+     * @param longitud Número de bytes de la línea
+     * @param offset Posición de la línea en el flujo, para reportar errores
+     * 
+     * Las cargas se acumulan en el lote; cualquier otra línea vacía antes
+     * el lote para respetar el orden de llegada.
+     */
+    void procesarLinea(const char* linea, size_t longitud, unsigned long long offset = 0);
+    
+    /**
+     * @brief Procesa una trama ya parseada (ReceptorTramas)
+     * @param trama Trama interpretada
+     * @param linea Texto original de la línea
+     * @param longitud Bytes de la línea
+     * @param offset Posición de la línea en el flujo
+     */
+    void alRecibirTrama(const TramaParseada& trama, const char* linea,
+                        size_t longitud, unsigned long long offset);
+    
+    /**
+     * @brief Reporta una línea inválida (ReceptorTramas)
+     * @param error Motivo del rechazo
+     * @param linea Texto original de la línea
+     * @param longitud Bytes de la línea
+     * @param offset Posición de la línea en el flujo
+     */
+    void alErrorParseo(ErrorParseo error, const char* linea,
+                       size_t longitud, unsigned long long offset);
+    
+    /**
+     * @brief Decodifica e inserta las cargas acumuladas
+     * 
+     * Aplica antes la rotación pendiente. Debe llamarse cuando la fuente se
+     * queda sin datos momentáneamente para no retener fragmentos, y antes
+     * de consultar la lista o el rotor.
+     */
+    void vaciarLote();
+    
+    /**
+     * @brief Cierra el mensaje actual como lo haría una trama FIN
+     * 
+     * Vacía el lote, entrega el mensaje, deja la lista vacía y reinicia el
+     * rotor si así se configuró.
+     */
+    void finalizarMensaje();
+    
+    /**
+     * @brief Elige si FIN reinicia el rotor
+     * @param reiniciar true para empezar cada mensaje con el rotor en 'A'
+     */
+    void setReiniciarRotorEnFin(bool reiniciar) { reiniciarRotorEnFin = reiniciar; }
+    
+    /**
+     * @brief Indica si FIN reinicia el rotor
+     * @return true si cada mensaje empieza con el rotor en 'A'
+     */
+    bool getReiniciarRotorEnFin() const { return reiniciarRotorEnFin; }
+    
+    /**
+     * @brief Obtiene el número de mensajes cerrados con FIN
+     * @return Mensajes completos entregados
+     */
+    long getMensajesCompletos() const { return mensajesCompletos; }
+    
+    /**
+     * @brief Imprime el mensaje ensamblado hasta ahora (vacía el lote antes)
+     */
+    void imprimirMensaje();
+    
+    /**
+     * @brief Obtiene el número de líneas procesadas
+     * @return Tramas recibidas, incluidas las que no se pudieron parsear
+     */
+    long getTramasRecibidas() const { return tramasRecibidas; }
+    
+    /**
+     * @brief Obtiene el número de líneas rechazadas por el parser
+     * @return Errores de parseo contados
+     */
+    long getErroresParseo() const { return erroresParseo; }
+    
+    /**
+     * @brief Activa o desactiva la impresión de errores de parseo
+     * @param activo false para solo contarlos (se reportan aparte)
+     */
+    void setReportarErrores(bool activo) { reportarErrores = activo; }
+    
+    /**
+     * @brief Suma tramas procesadas fuera de esta sesión
+     * @param tramas Líneas procesadas
+     * @param errores Líneas rechazadas entre ellas
+     */
+    void contarTramas(long tramas, long errores) {
+        tramasRecibidas += tramas;
+        erroresParseo += errores;
+    }
+    
+    /**
+     * @brief Retoma los contadores de una sesión anterior (ver GestorInstantaneas)
+     * @param mensajes Mensajes cerrados con FIN
+     * @param tramas Líneas procesadas
+     * @param errores Líneas rechazadas entre ellas
+     */
+    void restaurarContadores(long mensajes, long tramas, long errores) {
+        mensajesCompletos = mensajes;
+        tramasRecibidas = tramas;
+        erroresParseo = errores;
+    }
+    
+    /**
+     * @brief Activa la medición de la sesión
+     * @param destino Métricas a alimentar (0 = no medir)
+     */
+    void setMetricas(Metricas* destino) { metricas = destino; }
+    
+    /**
+     * @brief Métricas de la sesión
+     * @return Métricas asignadas, o 0
+     */
+    Metricas* getMetricas() { return metricas; }
+    
+    /**
+     * @brief Indica cuándo se leyó del puerto la próxima línea
+     * @param instanteNs Valor de relojNs() en la lectura (0 = desconocido)
+     * 
+     * Solo se usa con métricas: la espera y la latencia total se miden
+     * desde este instante.
+     */
+    void marcarLlegada(long long instanteNs) { llegada = instanteNs; }
+    
+    /**
+     * @brief Acceso a la lista del mensaje (el lote puede no estar vaciado)
+     * @return Lista de carga de la sesión
+     */
+    ListaDeCarga& getLista() { return lista; }
+    
+    /**
+     * @brief Acceso al rotor de la sesión (puede haber rotación pendiente)
+     * @return Rotor de mapeo
+     */
+    RotorDeMapeo& getRotor() { return rotor; }
+};
+
+#endif // DECODIFICADOR_H
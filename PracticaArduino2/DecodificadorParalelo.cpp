@@ -0,0 +1,256 @@
+/**
+ * @file DecodificadorParalelo.cpp
+ * @brief Implementación de la decodificación offline con varios hilos
+ */
+
+#include "DecodificadorParalelo.h"
+#include "ParserTramas.h"
+#include <iostream>
+#include <thread>
+
+namespace {
+
+/// Por debajo de este tamaño por hilo no compensa lanzar más hilos
+const size_t TRAMO_MINIMO = 1 << 20;
+
+/**
+ * @struct TramoCaptura
+ * @brief Porción de la captura asignada a un hilo
+ */
+struct TramoCaptura {
+    const char* inicio;             ///< Primer byte del tramo
+    size_t longitud;                ///< Bytes del tramo (termina en fin de línea)
+    unsigned long long offset;      ///< Posición del tramo en la captura
+    Decodificador* parcial;         ///< Sesión propia del hilo, rotor en la posición inicial
+    bool reiniciaEnFin;             ///< FIN devuelve el rotor a la posición inicial
+    int* fines;                     ///< Caracteres del mensaje parcial antes de cada FIN
+    int numFines;                   ///< FIN encontrados en el tramo
+    int capacidadFines;             ///< Capacidad de 'fines'
+    int rotacionInicial;            ///< Posición real del rotor al empezar el tramo
+};
+
+/**
+ * @class ReceptorTramo
+ * @brief Receptor de un hilo: decodifica el tramo y anota dónde cae cada FIN
+ *
+ * Los FIN no se procesan en el hilo (imprimirían un mensaje aún sin
+ * corregir y fuera de orden): solo se anota su posición en el mensaje
+ * parcial y, si corresponde, se reinicia el rotor del hilo. El resto de
+ * tramas pasa al Decodificador del tramo.
+ */
+class ReceptorTramo : public ReceptorTramas {
+    TramoCaptura& tramo;    ///< Tramo que se está decodificando
+
+public:
+    explicit ReceptorTramo(TramoCaptura& t) : tramo(t) {}
+
+    void alRecibirTrama(const TramaParseada& trama, const char* linea,
+                        size_t longitud, unsigned long long offset) {
+        Decodificador* parcial = tramo.parcial;
+        if (trama.tipo != TRAMA_FIN) {
+            parcial->alRecibirTrama(trama, linea, longitud, offset);
+            return;
+        }
+
+        parcial->vaciarLote();
+        if (tramo.numFines == tramo.capacidadFines) {
+            int capacidad = tramo.capacidadFines ? tramo.capacidadFines * 2 : 16;
+            int* nuevos = new int[capacidad];
+            for (int i = 0; i < tramo.numFines; i++) nuevos[i] = tramo.fines[i];
+            delete[] tramo.fines;
+            tramo.fines = nuevos;
+            tramo.capacidadFines = capacidad;
+        }
+        tramo.fines[tramo.numFines++] = parcial->getLista().getTamanio();
+
+        if (tramo.reiniciaEnFin) parcial->getRotor().reiniciar();
+        parcial->contarTramas(1, 0);
+    }
+
+    void alErrorParseo(ErrorParseo error, const char* linea,
+                       size_t longitud, unsigned long long offset) {
+        tramo.parcial->alErrorParseo(error, linea, longitud, offset);
+    }
+};
+
+/**
+ * @class ReportadorErrores
+ * @brief Receptor que solo imprime los errores de parseo
+ *
+ * Los hilos cuentan los errores sin imprimirlos; al terminar, los tramos con
+ * errores se vuelven a recorrer con este receptor para reportarlos en orden.
+ */
+class ReportadorErrores : public ReceptorTramas {
+public:
+    void alRecibirTrama(const TramaParseada& trama, const char* linea,
+                        size_t longitud, unsigned long long offset) {
+        (void)trama; (void)linea; (void)longitud; (void)offset;
+    }
+
+    void alErrorParseo(ErrorParseo error, const char* linea,
+                       size_t longitud, unsigned long long offset) {
+        (void)linea; (void)longitud;
+        std::cerr << "Error: " << describirError(error) << " (byte " << offset << ")" << std::endl;
+    }
+};
+
+/**
+ * @brief Primera fase: decodifica el tramo con el rotor en la posición inicial
+ * @param tramo Tramo a decodificar
+ */
+void decodificarTramo(TramoCaptura* tramo) {
+    ReceptorTramo receptor(*tramo);
+    tokenizarTramas(tramo->inicio, tramo->longitud, tramo->offset, receptor, true);
+    tramo->parcial->vaciarLote();
+}
+
+/**
+ * @brief Segunda fase: lleva el mensaje parcial a la posición real del rotor
+ * @param tramo Tramo ya decodificado, con 'rotacionInicial' calculada
+ */
+void corregirTramo(TramoCaptura* tramo) {
+    if (tramo->rotacionInicial == 0) return;
+
+    // Tras un FIN que reinicia el rotor los caracteres ya son correctos
+    int pendientes = tramo->parcial->getLista().getTamanio();
+    if (tramo->reiniciaEnFin && tramo->numFines > 0) pendientes = tramo->fines[0];
+
+    RotorDeMapeo corrector(tramo->parcial->getRotor().getAlfabeto(),
+                           tramo->parcial->getRotor().getTamanio());
+    corrector.rotar(tramo->rotacionInicial);
+
+    NodoCarga* nodo = tramo->parcial->getLista().getPrimerNodo();
+    for (; nodo && pendientes > 0; nodo = nodo->siguiente) {
+        int n = nodo->usados < pendientes ? nodo->usados : pendientes;
+        corrector.mapearBloque(nodo->datos(), nodo->datos(), n);
+        pendientes -= n;
+    }
+}
+
+/**
+ * @brief Anexa un mensaje parcial a 'destino', cerrando los mensajes en sus FIN
+ * @param tramo Tramo ya corregido
+ * @param destino Sesión que recibe los caracteres
+ */
+void anexarConFines(TramoCaptura* tramo, Decodificador& destino) {
+    ListaDeCarga& lista = destino.getLista();
+    int posicion = 0;
+    int fin = 0;
+
+    for (NodoCarga* nodo = tramo->parcial->getLista().getPrimerNodo(); nodo; nodo = nodo->siguiente) {
+        int k = 0;
+        while (k < nodo->usados) {
+            while (fin < tramo->numFines && tramo->fines[fin] == posicion) {
+                destino.finalizarMensaje();
+                fin++;
+            }
+
+            int n = nodo->usados - k;
+            if (fin < tramo->numFines && tramo->fines[fin] - posicion < n) {
+                n = tramo->fines[fin] - posicion;
+            }
+            lista.insertarBloque(nodo->datos() + k, n);
+            k += n;
+            posicion += n;
+        }
+    }
+
+    // FIN al final del tramo (o varios seguidos)
+    for (; fin < tramo->numFines; fin++) destino.finalizarMensaje();
+}
+
+} // namespace
+
+void decodificarEnParalelo(const char* datos, size_t n, int hilos, Decodificador& destino) {
+    if (hilos <= 0) {
+        hilos = (int)std::thread::hardware_concurrency();
+        if (hilos <= 0) hilos = 1;
+    }
+    if ((size_t)hilos > n / TRAMO_MINIMO) {
+        hilos = (int)(n / TRAMO_MINIMO);
+        if (hilos < 1) hilos = 1;
+    }
+
+    int capacidad = destino.getLista().getCapacidadNodo();
+    const char* alfabeto = destino.getRotor().getAlfabeto();
+    TramoCaptura* tramos = new TramoCaptura[hilos];
+
+    // Cortar en tramos de tamaño parecido, justo después de un fin de línea
+    size_t inicio = 0;
+    int usados = 0;
+    for (int i = 0; i < hilos && inicio < n; i++) {
+        size_t fin = (i == hilos - 1) ? n : n / hilos * (i + 1);
+        if (fin < inicio) fin = inicio;
+        if (fin < n) {
+            const char* salto = buscarFinDeLinea(datos + fin, datos + n);
+            fin = (salto == datos + n) ? n : (size_t)(salto - datos) + 1;
+        }
+
+        tramos[i].inicio = datos + inicio;
+        tramos[i].longitud = fin - inicio;
+        tramos[i].offset = inicio;
+        tramos[i].parcial = new Decodificador(capacidad, alfabeto, destino.getRotor().getTamanio());
+        tramos[i].parcial->setReportarErrores(false);
+        tramos[i].reiniciaEnFin = destino.getReiniciarRotorEnFin();
+        tramos[i].fines = 0;
+        tramos[i].numFines = 0;
+        tramos[i].capacidadFines = 0;
+        tramos[i].rotacionInicial = 0;
+        usados++;
+        inicio = fin;
+    }
+
+    // Fase 1: cada hilo decodifica su tramo como si el rotor empezara en 'A'
+    std::thread* trabajadores = new std::thread[usados];
+    for (int i = 0; i < usados; i++) {
+        trabajadores[i] = std::thread(decodificarTramo, &tramos[i]);
+    }
+    for (int i = 0; i < usados; i++) trabajadores[i].join();
+
+    // Prefijo exclusivo de las rotaciones netas. Un tramo con un FIN que
+    // reinicia el rotor termina en su propia rotación, sin importar la previa
+    int tamanio = destino.getRotor().getTamanio();
+    int acumulado = destino.getRotor().getDesplazamiento();
+    for (int i = 0; i < usados; i++) {
+        tramos[i].rotacionInicial = acumulado;
+        int neta = tramos[i].parcial->getRotor().getDesplazamiento();
+        if (tramos[i].reiniciaEnFin && tramos[i].numFines > 0) {
+            acumulado = neta;
+        } else {
+            acumulado = (acumulado + neta) % tamanio;
+        }
+    }
+
+    // Fase 2: corregir en paralelo cada mensaje parcial
+    for (int i = 0; i < usados; i++) {
+        trabajadores[i] = std::thread(corregirTramo, &tramos[i]);
+    }
+    for (int i = 0; i < usados; i++) trabajadores[i].join();
+    delete[] trabajadores;
+
+    // Anexar en orden, cerrando cada mensaje en su FIN, y dejar el rotor de
+    // destino donde lo habría dejado la decodificación secuencial
+    destino.vaciarLote();
+    ReportadorErrores reportador;
+    for (int i = 0; i < usados; i++) {
+        Decodificador* parcial = tramos[i].parcial;
+
+        if (parcial->getErroresParseo() > 0) {
+            tokenizarTramas(tramos[i].inicio, tramos[i].longitud, tramos[i].offset,
+                            reportador, true);
+        }
+
+        if (tramos[i].numFines == 0) {
+            destino.getLista().moverAlFinal(parcial->getLista());
+        } else {
+            anexarConFines(&tramos[i], destino);
+        }
+        destino.contarTramas(parcial->getTramasRecibidas(), parcial->getErroresParseo());
+        delete parcial;
+        delete[] tramos[i].fines;
+    }
+    destino.getRotor().reiniciar();
+    destino.getRotor().rotar(acumulado);
+
+    delete[] tramos;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file DecodificadorParalelo.h
+ * @brief Decodificación offline de capturas grandes repartida entre hilos
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef DECODIFICADOR_PARALELO_H
+#define DECODIFICADOR_PARALELO_H
+
+#include <cstddef>
+#include "Decodificador.h"
+
+/**
+ * @brief Decodifica una captura completa usando varios hilos
+ * @param datos Contenido de la captura (por ejemplo, un ArchivoMapeado)
+ * @param n Bytes de la captura
+ * @param hilos Número de hilos; 0 usa los núcleos disponibles
+ * @param destino Sesión donde se anexa el mensaje y cuyo rotor avanza
+ *
+ * El estado del rotor en cada carga solo depende de la suma, módulo el
+ * tamaño del alfabeto, de las rotaciones anteriores. Y rotar el resultado
+ * de un mapeo equivale a haber mapeado con el rotor ya rotado. Por eso:
+ *
+ *  1. La captura se corta en tramos que terminan en fin de línea.
+ *  2. Cada hilo decodifica su tramo con un rotor en la posición inicial y
+ *     anota la rotación neta del tramo.
+ *  3. Un prefijo exclusivo de esas rotaciones da la posición real del
+ *     rotor al comienzo de cada tramo.
+ *  4. Cada hilo corrige en sitio su mensaje parcial con mapearBloque().
+ *  5. Los mensajes parciales se anexan en orden a la lista de 'destino'
+ *     sin copiar caracteres (ListaDeCarga::moverAlFinal()).
+ *
+ * Los FIN se anotan como posiciones dentro de cada mensaje parcial y se
+ * procesan al anexar, en orden. Si FIN reinicia el rotor, el tramo que lo
+ * contiene fija su propia rotación final en el prefijo y solo se corrigen
+ * los caracteres anteriores a su primer FIN.
+ *
+ * No hay diagnóstico por trama (equivale a --modo silencioso). Los errores
+ * de parseo se imprimen al final, en orden de aparición y con su byte.
+ */
+void decodificarEnParalelo(const char* datos, size_t n, int hilos, Decodificador& destino);
+
+#endif // DECODIFICADOR_PARALELO_H
@@ -0,0 +1,119 @@
+/**
+ * @file GeneradorTramas.cpp
+ * @brief Implementación del generador de flujos PRT-7
+ */
+
+#include "GeneradorTramas.h"
+#include <climits>
+
+namespace {
+
+/// Símbolos que puede llevar una carga (se envían como "L,X" o "L,Space")
+const char SIMBOLOS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ ";
+const int NUM_SIMBOLOS = 27;
+
+/**
+ * @brief Escribe un entero en decimal
+ * @param destino Buffer de salida
+ * @param valor Entero a escribir
+ * @return Bytes escritos
+ */
+size_t escribirEntero(char* destino, int valor) {
+    size_t n = 0;
+    unsigned long long magnitud;
+    if (valor < 0) {
+        destino[n++] = '-';
+        magnitud = (unsigned long long)(-(long long)valor);
+    } else {
+        magnitud = (unsigned long long)valor;
+    }
+
+    char digitos[20];
+    int k = 0;
+    do {
+        digitos[k++] = (char)('0' + magnitud % 10);
+        magnitud /= 10;
+    } while (magnitud > 0);
+
+    while (k > 0) destino[n++] = digitos[--k];
+    return n;
+}
+
+} // namespace
+
+GeneradorTramas::GeneradorTramas(const ConfiguracionGenerador& configuracion)
+    : config(configuracion), estado(configuracion.semilla ? configuracion.semilla : 1),
+      cargasEnMensaje(0), tramas(0) {}
+
+unsigned long long GeneradorTramas::aleatorio() {
+    estado ^= estado >> 12;
+    estado ^= estado << 25;
+    estado ^= estado >> 27;
+    return estado * 2685821657736338717ULL;
+}
+
+unsigned long long GeneradorTramas::aleatorioMenorQue(unsigned long long n) {
+    // Los bits altos de xorshift64* son los de mejor calidad
+    return (aleatorio() >> 11) % n;
+}
+
+size_t GeneradorTramas::siguiente(char* destino) {
+    size_t n = 0;
+
+    if (config.longitudMensaje > 0 && cargasEnMensaje >= config.longitudMensaje) {
+        // Fin del mensaje actual
+        destino[n++] = 'F';
+        destino[n++] = 'I';
+        destino[n++] = 'N';
+        cargasEnMensaje = 0;
+    } else if ((int)aleatorioMenorQue(100) < config.porcentajeMapeo) {
+        // Trama de mapeo
+        int rotacion;
+        if (config.distribucion == ROTACION_PEQUENA) {
+            rotacion = (int)aleatorioMenorQue(7) - 3;
+        } else if (config.distribucion == ROTACION_EXTREMA) {
+            // Uno de cada ocho valores es un extremo exacto del rango
+            unsigned long long r = aleatorio();
+            if ((r & 7) == 0) {
+                rotacion = (r & 8) ? INT_MAX : INT_MIN;
+            } else {
+                rotacion = (int)((long long)(r >> 32) - 0x80000000LL);
+            }
+        } else {
+            unsigned long long rango = 2ULL * (unsigned long long)config.rotacionMaxima + 1;
+            rotacion = (int)((long long)aleatorioMenorQue(rango) - config.rotacionMaxima);
+        }
+
+        destino[n++] = 'M';
+        destino[n++] = ',';
+        n += escribirEntero(destino + n, rotacion);
+    } else {
+        // Trama de carga
+        char c = SIMBOLOS[aleatorioMenorQue(NUM_SIMBOLOS)];
+        destino[n++] = 'L';
+        destino[n++] = ',';
+        if (c == ' ') {
+            destino[n++] = 'S';
+            destino[n++] = 'p';
+            destino[n++] = 'a';
+            destino[n++] = 'c';
+            destino[n++] = 'e';
+        } else {
+            destino[n++] = c;
+        }
+        cargasEnMensaje++;
+    }
+
+    if (config.finDeLineaCRLF) destino[n++] = '\r';
+    destino[n++] = '\n';
+    tramas++;
+    return n;
+}
+
+size_t GeneradorTramas::generar(char* destino, size_t capacidad) {
+    size_t usados = 0;
+    while (capacidad - usados >= MAX_TRAMA) {
+        usados += siguiente(destino + usados);
+    }
+    return usados;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file GeneradorTramas.h
+ * @brief Generador determinista de flujos PRT-7 sintéticos
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef GENERADOR_TRAMAS_H
+#define GENERADOR_TRAMAS_H
+
+#include <cstddef>
+
+/**
+ * @enum DistribucionRotacion
+ * @brief Cómo se eligen los valores de las tramas MAP
+ */
+enum DistribucionRotacion {
+    ROTACION_PEQUENA,   ///< Entre -3 y 3 (como el transmisor de ejemplo)
+    ROTACION_UNIFORME,  ///< Entre -rotacionMaxima y rotacionMaxima
+    ROTACION_EXTREMA    ///< Cualquier int, incluidos INT_MIN e INT_MAX
+};
+
+/**
+ * @struct ConfiguracionGenerador
+ * @brief Parámetros del flujo sintético
+ */
+struct ConfiguracionGenerador {
+    unsigned long long semilla;         ///< Misma semilla = mismo flujo en cualquier plataforma
+    int porcentajeMapeo;                ///< Porcentaje de tramas MAP (0-100)
+    DistribucionRotacion distribucion;  ///< Valores de las tramas MAP
+    int rotacionMaxima;                 ///< Límite de ROTACION_UNIFORME
+    int longitudMensaje;                ///< Cargas entre dos FIN (0 = sin FIN)
+    bool finDeLineaCRLF;                ///< "\r\n" como Serial.println() o solo "\n"
+
+    /**
+     * @brief Constructor con un flujo parecido al del Arduino
+     */
+    ConfiguracionGenerador()
+        : semilla(1), porcentajeMapeo(20), distribucion(ROTACION_UNIFORME),
+          rotacionMaxima(100), longitudMensaje(0), finDeLineaCRLF(true) {}
+};
+
+/**
+ * @class GeneradorTramas
+ * @brief Produce líneas PRT-7 válidas de forma reproducible
+ *
+ * Usa su propio generador pseudoaleatorio (xorshift64*) en lugar de
+ * rand(), así que un mismo flujo se reproduce idéntico en Linux, Mac y
+ * Windows: sirve para comparar mediciones entre versiones y máquinas.
+ */
+class GeneradorTramas {
+public:
+    static const size_t MAX_TRAMA = 16;     ///< Bytes máximos de una línea ("M,-2147483648\r\n")
+
+private:
+    ConfiguracionGenerador config;  ///< Parámetros del flujo
+    unsigned long long estado;      ///< Estado del generador pseudoaleatorio
+    int cargasEnMensaje;            ///< Cargas desde el último FIN
+    unsigned long long tramas;      ///< Líneas generadas
+
+    /**
+     * @brief Siguiente número pseudoaleatorio de 64 bits
+     */
+    unsigned long long aleatorio();
+
+    /**
+     * @brief Número pseudoaleatorio en [0, n)
+     * @param n Límite exclusivo (mayor que 0)
+     */
+    unsigned long long aleatorioMenorQue(unsigned long long n);
+
+public:
+    /**
+     * @brief Constructor
+     * @param configuracion Parámetros del flujo
+     */
+    GeneradorTramas(const ConfiguracionGenerador& configuracion = ConfiguracionGenerador());
+
+    /**
+     * @brief Escribe la siguiente línea, con su terminador
+     * @param destino Buffer de al menos MAX_TRAMA bytes
+     * @return Bytes escritos
+     */
+    size_t siguiente(char* destino);
+
+    /**
+     * @brief Llena un buffer con líneas completas
+     * @param destino Buffer de salida
+     * @param capacidad Bytes disponibles
+     * @return Bytes escritos (nunca corta una línea)
+     */
+    size_t generar(char* destino, size_t capacidad);
+
+    /**
+     * @brief Líneas generadas hasta ahora
+     */
+    unsigned long long getTramas() const { return tramas; }
+};
+
+#endif // GENERADOR_TRAMAS_H
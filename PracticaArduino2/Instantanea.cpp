@@ -0,0 +1,301 @@
+/**
+ * @file Instantanea.cpp
+ * @brief Implementación de las instantáneas de sesión
+ */
+
+#include "Instantanea.h"
+#include "Metricas.h"
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <io.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+/// Primeros bytes de todo archivo de instantánea
+const char FIRMA[8] = { 'P', 'R', 'T', '7', 'I', 'N', 'S', 'T' };
+
+/// Bytes de los campos de longitud fija (firma incluida, suma excluida)
+const size_t TAM_CAMPOS = 8 + 4 + 8 + 1 + 8 + 2 + 2 + 8 + 8 + 8 + 8 + 4;
+
+/// Bytes de la suma de comprobación final
+const size_t TAM_SUMA = 8;
+
+/**
+ * @brief Escribe un entero en little-endian y avanza el cursor
+ * @param p Cursor de escritura
+ * @param valor Valor a escribir
+ * @param bytes Bytes que ocupa el campo
+ */
+void escribirEntero(char*& p, unsigned long long valor, int bytes) {
+    for (int i = 0; i < bytes; i++) *p++ = (char)(unsigned char)(valor >> (8 * i));
+}
+
+/**
+ * @brief Lee un entero en little-endian y avanza el cursor
+ * @param p Cursor de lectura
+ * @param bytes Bytes que ocupa el campo
+ * @return Valor leído
+ */
+unsigned long long leerEntero(const char*& p, int bytes) {
+    unsigned long long valor = 0;
+    for (int i = 0; i < bytes; i++) valor |= (unsigned long long)(unsigned char)*p++ << (8 * i);
+    return valor;
+}
+
+/**
+ * @brief Suma de comprobación FNV-1a de 64 bits
+ * @param datos Bytes a resumir
+ * @param n Número de bytes
+ * @return Resumen de los bytes
+ */
+unsigned long long sumaComprobacion(const char* datos, size_t n) {
+    unsigned long long suma = 1469598103934665603ULL;
+    for (size_t i = 0; i < n; i++) {
+        suma ^= (unsigned char)datos[i];
+        suma *= 1099511628211ULL;
+    }
+    return suma;
+}
+
+/**
+ * @brief Crea un archivo con el contenido dado y lo sincroniza con el disco
+ * @param ruta Archivo a crear (se trunca si existe)
+ * @param datos Contenido completo
+ * @param n Número de bytes
+ * @return false si falló alguna escritura o la sincronización
+ */
+bool escribirArchivo(const char* ruta, const char* datos, size_t n) {
+#ifdef _WIN32
+    int fd = _open(ruta, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    int fd = open(ruta, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    if (fd < 0) return false;
+
+    size_t hecho = 0;
+    while (hecho < n) {
+#ifdef _WIN32
+        int r = _write(fd, datos + hecho, (unsigned int)(n - hecho));
+#else
+        ssize_t r = write(fd, datos + hecho, n - hecho);
+#endif
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        hecho += (size_t)r;
+    }
+
+#ifdef _WIN32
+    bool correcto = hecho == n && _commit(fd) == 0;
+    _close(fd);
+#else
+    bool correcto = hecho == n && fsync(fd) == 0;
+    close(fd);
+#endif
+    return correcto;
+}
+
+/**
+ * @brief Reemplaza 'destino' por 'origen' de forma atómica
+ * @return false si no se pudo renombrar
+ *
+ * En Linux/Mac también sincroniza el directorio, para que el nuevo
+ * nombre sobreviva a una caída.
+ */
+bool reemplazarArchivo(const char* origen, const char* destino) {
+#ifdef _WIN32
+    return MoveFileExA(origen, destino, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (rename(origen, destino) != 0) return false;
+
+    char directorio[1024] = ".";
+    const char* barra = std::strrchr(destino, '/');
+    if (barra && (size_t)(barra - destino + 1) < sizeof(directorio)) {
+        size_t n = (size_t)(barra - destino + 1);
+        std::memcpy(directorio, destino, n);
+        directorio[n] = '\0';
+    }
+    int fd = open(directorio, O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+#endif
+}
+
+} // namespace
+
+GestorInstantaneas::GestorInstantaneas()
+    : ruta(0), rutaTemporal(0), intervaloNs(0), proximoNs(0), leida(0) {
+    std::memset(&estado, 0, sizeof(estado));
+}
+
+GestorInstantaneas::~GestorInstantaneas() {
+    delete[] rutaTemporal;
+    delete[] leida;
+}
+
+void GestorInstantaneas::abrir(const char* archivo, int intervaloSegundos) {
+    ruta = archivo;
+    size_t longitud = std::strlen(archivo);
+    delete[] rutaTemporal;
+    rutaTemporal = new char[longitud + 5];
+    std::memcpy(rutaTemporal, archivo, longitud);
+    std::memcpy(rutaTemporal + longitud, ".tmp", 5);
+
+    intervaloNs = (long long)intervaloSegundos * 1000000000LL;
+    proximoNs = relojNs() + intervaloNs;
+}
+
+int GestorInstantaneas::cargar() {
+    if (!ruta) return 0;
+
+    std::ifstream archivo(ruta, std::ios::in | std::ios::binary);
+    if (!archivo) return 0;
+
+    archivo.seekg(0, std::ios::end);
+    std::streamoff tamanio = archivo.tellg();
+    archivo.seekg(0, std::ios::beg);
+    if (tamanio < (std::streamoff)(TAM_CAMPOS + TAM_SUMA)) {
+        std::cerr << "Error: Instantanea incompleta: " << ruta << std::endl;
+        return -1;
+    }
+
+    delete[] leida;
+    leida = new char[(size_t)tamanio];
+    if (!archivo.read(leida, tamanio)) {
+        std::cerr << "Error: No se pudo leer la instantanea " << ruta << std::endl;
+        return -1;
+    }
+
+    // Firma, versión y suma antes de fiarse de ningún campo
+    size_t cuerpo = (size_t)tamanio - TAM_SUMA;
+    const char* p = leida + cuerpo;
+    if (std::memcmp(leida, FIRMA, sizeof(FIRMA)) != 0 ||
+        leerEntero(p, 8) != sumaComprobacion(leida, cuerpo)) {
+        std::cerr << "Error: Instantanea danada: " << ruta << std::endl;
+        return -1;
+    }
+    p = leida + sizeof(FIRMA);
+    unsigned long long version = leerEntero(p, 4);
+    if (version != VERSION) {
+        std::cerr << "Error: Version de instantanea no admitida (" << version << "): "
+                  << ruta << std::endl;
+        return -1;
+    }
+
+    estado.offset = leerEntero(p, 8);
+    unsigned long long sumidero = leerEntero(p, 1);
+    estado.bytesSumidero = leerEntero(p, 8);
+    estado.longitudAlfabeto = (int)leerEntero(p, 2);
+    estado.desplazamiento = (int)leerEntero(p, 2);
+    estado.mensajesCompletos = (long)leerEntero(p, 8);
+    estado.tramasRecibidas = (long)leerEntero(p, 8);
+    estado.erroresParseo = (long)leerEntero(p, 8);
+    estado.volcados = leerEntero(p, 8);
+    unsigned long long tamanioMensaje = leerEntero(p, 4);
+    estado.alfabeto = p;
+    estado.mensaje = p + estado.longitudAlfabeto;
+
+    if (sumidero > INSTANTANEA_ARCHIVO || estado.desplazamiento >= estado.longitudAlfabeto ||
+        tamanioMensaje > 0x7fffffffULL ||
+        TAM_CAMPOS + (size_t)estado.longitudAlfabeto + (size_t)tamanioMensaje != cuerpo) {
+        std::cerr << "Error: Instantanea danada: " << ruta << std::endl;
+        return -1;
+    }
+    estado.sumidero = (TipoSumideroInstantanea)sumidero;
+    estado.tamanioMensaje = (int)tamanioMensaje;
+    return 1;
+}
+
+bool GestorInstantaneas::restaurar(Decodificador& decodificador) {
+    RotorDeMapeo& rotor = decodificador.getRotor();
+    if (rotor.getTamanio() != estado.longitudAlfabeto ||
+        std::memcmp(rotor.getAlfabeto(), estado.alfabeto, (size_t)estado.longitudAlfabeto) != 0) {
+        std::cerr << "Error: La instantanea se tomo con otro --alfabeto" << std::endl;
+        return false;
+    }
+
+    rotor.reiniciar();
+    rotor.rotar(estado.desplazamiento);
+    decodificador.getLista().reanudarMensaje(estado.mensaje, estado.tamanioMensaje,
+                                             estado.volcados);
+    decodificador.restaurarContadores(estado.mensajesCompletos, estado.tramasRecibidas,
+                                      estado.erroresParseo);
+    return true;
+}
+
+bool GestorInstantaneas::pendiente() const {
+    return ruta && intervaloNs > 0 && relojNs() >= proximoNs;
+}
+
+bool GestorInstantaneas::guardar(Decodificador& decodificador, unsigned long long offset,
+                                 SumideroDescriptor* archivo) {
+    if (!ruta) return false;
+    proximoNs = relojNs() + intervaloNs;
+
+    // El rotor y la lista solo están al día con el lote vacío
+    decodificador.vaciarLote();
+    ListaDeCarga& lista = decodificador.getLista();
+    RotorDeMapeo& rotor = decodificador.getRotor();
+
+    TipoSumideroInstantanea sumidero = INSTANTANEA_SIN_SUMIDERO;
+    unsigned long long bytesSumidero = 0;
+    if (archivo) {
+        if (!archivo->sincronizar()) {
+            std::cerr << "Error: No se pudo sincronizar el sumidero; instantanea omitida" << std::endl;
+            return false;
+        }
+        sumidero = INSTANTANEA_ARCHIVO;
+        bytesSumidero = archivo->getBytesArchivo();
+    } else if (lista.getSumidero()) {
+        sumidero = INSTANTANEA_CONSOLA;
+    }
+
+    size_t total = TAM_CAMPOS + (size_t)rotor.getTamanio() + (size_t)lista.getTamanio() + TAM_SUMA;
+    char* buffer = new char[total];
+    char* p = buffer;
+    std::memcpy(p, FIRMA, sizeof(FIRMA));
+    p += sizeof(FIRMA);
+    escribirEntero(p, VERSION, 4);
+    escribirEntero(p, offset, 8);
+    escribirEntero(p, (unsigned long long)sumidero, 1);
+    escribirEntero(p, bytesSumidero, 8);
+    escribirEntero(p, (unsigned long long)rotor.getTamanio(), 2);
+    escribirEntero(p, (unsigned long long)rotor.getDesplazamiento(), 2);
+    escribirEntero(p, (unsigned long long)decodificador.getMensajesCompletos(), 8);
+    escribirEntero(p, (unsigned long long)decodificador.getTramasRecibidas(), 8);
+    escribirEntero(p, (unsigned long long)decodificador.getErroresParseo(), 8);
+    escribirEntero(p, lista.getVolcados(), 8);
+    escribirEntero(p, (unsigned long long)lista.getTamanio(), 4);
+    std::memcpy(p, rotor.getAlfabeto(), (size_t)rotor.getTamanio());
+    p += rotor.getTamanio();
+    for (NodoCarga* nodo = lista.getPrimerNodo(); nodo; nodo = nodo->siguiente) {
+        std::memcpy(p, nodo->datos(), (size_t)nodo->usados);
+        p += nodo->usados;
+    }
+    escribirEntero(p, sumaComprobacion(buffer, (size_t)(p - buffer)), 8);
+
+    bool correcto = escribirArchivo(rutaTemporal, buffer, total) &&
+                    reemplazarArchivo(rutaTemporal, ruta);
+    delete[] buffer;
+    if (!correcto) {
+        std::cerr << "Error: No se pudo escribir la instantanea " << ruta << ": "
+                  << std::strerror(errno) << std::endl;
+    }
+    return correcto;
+}
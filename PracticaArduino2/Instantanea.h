@@ -0,0 +1,135 @@
+/**
+ * @file Instantanea.h
+ * @brief Instantáneas del estado de decodificación para reanudar tras un reinicio
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef INSTANTANEA_H
+#define INSTANTANEA_H
+
+#include <cstddef>
+#include "Decodificador.h"
+#include "SumideroCarga.h"
+
+/**
+ * @enum TipoSumideroInstantanea
+ * @brief Destino del modo streaming cuando se tomó la instantánea
+ */
+enum TipoSumideroInstantanea {
+    INSTANTANEA_SIN_SUMIDERO = 0,   ///< La lista retenía todo el mensaje
+    INSTANTANEA_CONSOLA = 1,        ///< --sumidero -
+    INSTANTANEA_ARCHIVO = 2         ///< --sumidero RUTA
+};
+
+/**
+ * @struct Instantanea
+ * @brief Estado de una sesión leído de disco
+ *
+ * Los punteros apuntan al buffer del GestorInstantaneas que la cargó.
+ */
+struct Instantanea {
+    unsigned long long offset;      ///< Bytes del flujo ya decodificados
+    TipoSumideroInstantanea sumidero; ///< Modo streaming de la sesión
+    unsigned long long bytesSumidero; ///< Longitud del archivo del sumidero
+    const char* alfabeto;           ///< Símbolos del rotor
+    int longitudAlfabeto;           ///< Número de símbolos
+    int desplazamiento;             ///< Rotación neta del rotor
+    long mensajesCompletos;         ///< Mensajes cerrados con FIN
+    long tramasRecibidas;           ///< Líneas procesadas
+    long erroresParseo;             ///< Líneas rechazadas
+    unsigned long long volcados;    ///< Caracteres del mensaje ya en el sumidero
+    const char* mensaje;            ///< Caracteres que retenía la lista
+    int tamanioMensaje;             ///< Número de caracteres de 'mensaje'
+};
+
+/**
+ * @class GestorInstantaneas
+ * @brief Guarda y recupera el estado de una sesión en un archivo
+ *
+ * La instantánea contiene el desplazamiento del rotor, lo que retenía la
+ * lista de carga y la posición en el flujo, así que al reanudar solo se
+ * vuelven a leer las tramas posteriores. Se escribe completa en RUTA.tmp,
+ * se sincroniza con el disco y se renombra sobre RUTA: tras una caída
+ * queda la instantánea anterior o la nueva, nunca una mezcla. Una suma de
+ * comprobación descarta además archivos dañados.
+ *
+ * Se toma cada 'intervalo' segundos (comprobado entre tramos de tramas)
+ * y al terminar el flujo.
+ */
+class GestorInstantaneas {
+    const char* ruta;           ///< Archivo de la instantánea, o 0 si está desactivado
+    char* rutaTemporal;         ///< ruta + ".tmp"
+    long long intervaloNs;      ///< Periodo entre instantáneas (0 = solo al final)
+    long long proximoNs;        ///< Próxima instantánea periódica
+    char* leida;                ///< Contenido del archivo cargado
+    Instantanea estado;         ///< Campos de 'leida' ya interpretados
+
+    // No se permite copiar: posee los buffers
+    GestorInstantaneas(const GestorInstantaneas&);
+    GestorInstantaneas& operator=(const GestorInstantaneas&);
+
+public:
+    static const unsigned int VERSION = 1;  ///< Versión del formato en disco
+
+    /**
+     * @brief Constructor de un gestor desactivado
+     */
+    GestorInstantaneas();
+
+    /**
+     * @brief Destructor que libera los buffers
+     */
+    ~GestorInstantaneas();
+
+    /**
+     * @brief Activa las instantáneas
+     * @param archivo Ruta de la instantánea (no se copia)
+     * @param intervaloSegundos Periodo entre instantáneas (0 = solo al final)
+     */
+    void abrir(const char* archivo, int intervaloSegundos);
+
+    /**
+     * @brief Indica si las instantáneas están activas
+     */
+    bool activo() const { return ruta != 0; }
+
+    /**
+     * @brief Lee la instantánea del archivo, si existe
+     * @return 1 si se cargó, 0 si no hay instantánea, -1 si está dañada o
+     *         es de otra versión
+     */
+    int cargar();
+
+    /**
+     * @brief Estado leído por el último cargar() que devolvió 1
+     */
+    const Instantanea& getEstado() const { return estado; }
+
+    /**
+     * @brief Deja una sesión recién creada en el estado cargado
+     * @param decodificador Sesión vacía, con el sumidero ya configurado
+     * @return false si el rotor usa otro alfabeto que la instantánea
+     */
+    bool restaurar(Decodificador& decodificador);
+
+    /**
+     * @brief Indica si toca tomar una instantánea periódica
+     */
+    bool pendiente() const;
+
+    /**
+     * @brief Escribe el estado actual de una sesión
+     * @param decodificador Sesión a guardar (se vacía su lote)
+     * @param offset Bytes del flujo ya entregados a la sesión
+     * @param archivo Sumidero en archivo de la sesión, o 0 si no lo hay
+     * @return false si no se pudo escribir (la instantánea anterior sigue valiendo)
+     *
+     * El sumidero se sincroniza antes, para que lo que la instantánea da
+     * por volcado esté en el disco.
+     */
+    bool guardar(Decodificador& decodificador, unsigned long long offset,
+                 SumideroDescriptor* archivo);
+};
+
+#endif // INSTANTANEA_H
@@ -5,20 +5,51 @@
 
 #include "ListaDeCarga.h"
 #include <iostream>
+#include <cstring>
+#include <new>
 
-ListaDeCarga::ListaDeCarga() : cabeza(0), cola(0), tamanio(0) {}
+ListaDeCarga::ListaDeCarga(int capacidad)
+    : cabeza(0), cola(0), tamanio(0), capacidadNodo(capacidad),
+      bytesNodo(0), bloques(0), usadosEnBloque(0), libres(0),
+      sumidero(0), ventana(0), volcados(0), buscador(0),
+      indiceNodos(0), indiceInicios(0), indiceUsados(0), indiceCapacidad(0) {
+    if (capacidadNodo < 1) capacidadNodo = 1;
+    if (capacidadNodo > CAPACIDAD_MAXIMA) capacidadNodo = CAPACIDAD_MAXIMA;
+    bytesNodo = NodoCarga::tamanioPara(capacidadNodo);
+}
 
 ListaDeCarga::~ListaDeCarga() {
-    NodoCarga* actual = cabeza;
-    while (actual) {
-        NodoCarga* siguiente = actual->siguiente;
-        delete actual;
-        actual = siguiente;
+    delete[] indiceNodos;
+    delete[] indiceInicios;
+    
+    // NodoCarga no tiene destructor propio: basta liberar los bloques
+    while (bloques) {
+        BloqueNodos* anterior = bloques->siguiente;
+        delete bloques;
+        bloques = anterior;
     }
 }
 
-void ListaDeCarga::insertarAlFinal(char dato) {
-    NodoCarga* nuevo = new NodoCarga(dato);
+void* ListaDeCarga::reservarNodo() {
+    // Reutilizar primero los nodos ya volcados al sumidero
+    if (libres) {
+        NodoCarga* nodo = libres;
+        libres = libres->siguiente;
+        return nodo;
+    }
+    
+    if (!bloques || usadosEnBloque + bytesNodo > BloqueNodos::TAM_MEMORIA) {
+        bloques = new BloqueNodos(bloques);
+        usadosEnBloque = 0;
+    }
+    
+    void* memoria = bloques->memoria + usadosEnBloque;
+    usadosEnBloque += bytesNodo;
+    return memoria;
+}
+
+void ListaDeCarga::agregarNodo(char dato) {
+    NodoCarga* nuevo = new (reservarNodo()) NodoCarga(dato, capacidadNodo);
     
     if (!cabeza) {
         // Lista vacía: el nuevo nodo es cabeza y cola
@@ -30,19 +61,283 @@ void ListaDeCarga::insertarAlFinal(char dato) {
         nuevo->previo = cola;
         cola = nuevo;
     }
+}
+
+void ListaDeCarga::insertarAlFinal(char dato) {
+    if (buscador) buscador->procesar(&dato, 1, volcados + (unsigned long long)tamanio);
+    
+    if (cola && cola->usados < capacidadNodo) {
+        // Hay espacio en el último nodo
+        cola->datos()[cola->usados++] = dato;
+    } else {
+        agregarNodo(dato);
+    }
     
     tamanio++;
+    if (sumidero && tamanio > ventana + UMBRAL_VOLCADO) recortar();
+}
+
+void ListaDeCarga::insertarBloque(const char* datos, int n) {
+    if (buscador) buscador->procesar(datos, (size_t)n, volcados + (unsigned long long)tamanio);
+    
+    int i = 0;
+    while (i < n) {
+        if (!cola || cola->usados == capacidadNodo) {
+            agregarNodo(datos[i++]);
+            tamanio++;
+            continue;
+        }
+        
+        // Llenar lo que quede del último nodo de una sola vez
+        int libres = capacidadNodo - cola->usados;
+        int copiar = (n - i < libres) ? n - i : libres;
+        std::memcpy(cola->datos() + cola->usados, datos + i, copiar);
+        cola->usados += copiar;
+        tamanio += copiar;
+        i += copiar;
+    }
+    
+    if (sumidero && tamanio > ventana + UMBRAL_VOLCADO) recortar();
+}
+
+void ListaDeCarga::setSumidero(SumideroCarga* destino, int caracteres) {
+    sumidero = destino;
+    ventana = caracteres < 0 ? 0 : caracteres;
+    if (sumidero && tamanio > ventana + UMBRAL_VOLCADO) recortar();
+}
+
+void ListaDeCarga::setBuscador(BuscadorPalabras* destino) {
+    buscador = destino;
+    if (!buscador || tamanio == 0) return;
+    
+    // Basta el final del mensaje: ninguna palabra es más larga
+    char final[BuscadorPalabras::MAX_LONGITUD];
+    int n = tamanio < BuscadorPalabras::MAX_LONGITUD - 1 ? tamanio : BuscadorPalabras::MAX_LONGITUD - 1;
+    n = copiarTramo(getLongitudMensaje() - (unsigned long long)n, final, n);
+    buscador->sincronizar(final, (size_t)n);
+}
+
+void ListaDeCarga::reanudarMensaje(const char* datos, int n, unsigned long long volcadosPrevios) {
+    // Lo retenido ya se vigiló antes de la instantánea: solo se sincroniza
+    BuscadorPalabras* activo = buscador;
+    buscador = 0;
+    vaciar();
+    volcados = volcadosPrevios;
+    insertarBloque(datos, n);
+    setBuscador(activo);
+}
+
+void ListaDeCarga::recortar() {
+    // Los nodos volcados se reutilizan: el índice se rehace en la próxima consulta
+    indiceUsados = 0;
+    
+    // Con buscador se retiene al menos la palabra más larga, para que una
+    // instantánea pueda resincronizarlo aunque la ventana sea menor
+    int retener = ventana;
+    if (buscador && retener < BuscadorPalabras::MAX_LONGITUD - 1) {
+        retener = BuscadorPalabras::MAX_LONGITUD - 1;
+    }
+    
+    // Volcar nodos completos desde la cabeza mientras quede lo retenido
+    while (cabeza && tamanio - cabeza->usados >= retener) {
+        NodoCarga* nodo = cabeza;
+        sumidero->escribir(nodo->datos(), (size_t)nodo->usados);
+        volcados += (unsigned long long)nodo->usados;
+        tamanio -= nodo->usados;
+        
+        cabeza = nodo->siguiente;
+        if (cabeza) {
+            cabeza->previo = 0;
+        } else {
+            cola = 0;
+        }
+        
+        nodo->siguiente = libres;
+        libres = nodo;
+    }
+}
+
+void ListaDeCarga::cerrarMensaje() {
+    if (sumidero) {
+        for (NodoCarga* actual = cabeza; actual; actual = actual->siguiente) {
+            sumidero->escribir(actual->datos(), (size_t)actual->usados);
+        }
+        sumidero->finMensaje();
+    }
+    vaciar();
+}
+
+void ListaDeCarga::vaciar() {
+    if (bloques) {
+        BloqueNodos* anterior = bloques->siguiente;
+        while (anterior) {
+            BloqueNodos* siguiente = anterior->siguiente;
+            delete anterior;
+            anterior = siguiente;
+        }
+        bloques->siguiente = 0;
+    }
+    
+    usadosEnBloque = 0;
+    libres = 0;
+    cabeza = 0;
+    cola = 0;
+    tamanio = 0;
+    volcados = 0;
+    indiceUsados = 0;
+    if (buscador) buscador->reiniciar();
+}
+
+void ListaDeCarga::moverAlFinal(ListaDeCarga& otra) {
+    if (&otra == this || !otra.cabeza) return;
+    
+    if (otra.capacidadNodo != capacidadNodo) {
+        // Nodos de distinto tamaño: copiar los caracteres
+        for (NodoCarga* actual = otra.cabeza; actual; actual = actual->siguiente) {
+            insertarBloque(actual->datos(), actual->usados);
+        }
+        otra.vaciar();
+        return;
+    }
+    
+    if (buscador) {
+        unsigned long long posicion = volcados + (unsigned long long)tamanio;
+        for (NodoCarga* actual = otra.cabeza; actual; actual = actual->siguiente) {
+            buscador->procesar(actual->datos(), (size_t)actual->usados, posicion);
+            posicion += (unsigned long long)actual->usados;
+        }
+    }
+    
+    // Enlazar los nodos de 'otra' después de la cola
+    if (!cabeza) {
+        cabeza = otra.cabeza;
+    } else {
+        cola->siguiente = otra.cabeza;
+        otra.cabeza->previo = cola;
+    }
+    cola = otra.cola;
+    tamanio += otra.tamanio;
+    
+    // Adoptar sus bloques de memoria detrás del bloque actual, que sigue
+    // siendo del que se recortan los nodos nuevos
+    BloqueNodos* ultimo = otra.bloques;
+    while (ultimo->siguiente) ultimo = ultimo->siguiente;
+    if (bloques) {
+        ultimo->siguiente = bloques->siguiente;
+        bloques->siguiente = otra.bloques;
+    } else {
+        bloques = otra.bloques;
+        usadosEnBloque = otra.usadosEnBloque;
+    }
+    
+    otra.cabeza = 0;
+    otra.cola = 0;
+    otra.tamanio = 0;
+    otra.bloques = 0;
+    otra.usadosEnBloque = 0;
+    otra.libres = 0;
+    otra.indiceUsados = 0;
+    
+    if (sumidero && tamanio > ventana + UMBRAL_VOLCADO) recortar();
+}
+
+void ListaDeCarga::actualizarIndice() {
+    NodoCarga* nodo;
+    unsigned long long inicio;
+    if (indiceUsados == 0) {
+        nodo = cabeza;
+        inicio = volcados;
+    } else {
+        // El último nodo indexado pudo crecer desde entonces
+        NodoCarga* ultimo = indiceNodos[indiceUsados - 1];
+        nodo = ultimo->siguiente;
+        inicio = indiceInicios[indiceUsados - 1] + (unsigned long long)ultimo->usados;
+    }
+    
+    for (; nodo; nodo = nodo->siguiente) {
+        if (indiceUsados == indiceCapacidad) {
+            int capacidad = indiceCapacidad ? indiceCapacidad * 2 : 64;
+            NodoCarga** nodos = new NodoCarga*[capacidad];
+            unsigned long long* inicios = new unsigned long long[capacidad];
+            for (int i = 0; i < indiceUsados; i++) {
+                nodos[i] = indiceNodos[i];
+                inicios[i] = indiceInicios[i];
+            }
+            delete[] indiceNodos;
+            delete[] indiceInicios;
+            indiceNodos = nodos;
+            indiceInicios = inicios;
+            indiceCapacidad = capacidad;
+        }
+        indiceNodos[indiceUsados] = nodo;
+        indiceInicios[indiceUsados] = inicio;
+        indiceUsados++;
+        inicio += (unsigned long long)nodo->usados;
+    }
+}
+
+int ListaDeCarga::buscarNodo(unsigned long long posicion) {
+    if (posicion < volcados || posicion >= getLongitudMensaje()) return -1;
+    actualizarIndice();
+    
+    // Última entrada cuyo inicio no pasa de 'posicion'
+    int bajo = 0;
+    int alto = indiceUsados - 1;
+    while (bajo < alto) {
+        int medio = bajo + (alto - bajo + 1) / 2;
+        if (indiceInicios[medio] <= posicion) {
+            bajo = medio;
+        } else {
+            alto = medio - 1;
+        }
+    }
+    return bajo;
+}
+
+bool ListaDeCarga::obtenerCaracter(unsigned long long posicion, char& c) {
+    int entrada = buscarNodo(posicion);
+    if (entrada < 0) return false;
+    
+    c = indiceNodos[entrada]->datos()[posicion - indiceInicios[entrada]];
+    return true;
+}
+
+int ListaDeCarga::copiarTramo(unsigned long long posicion, char* destino, int n) {
+    int entrada = buscarNodo(posicion);
+    if (entrada < 0) return 0;
+    
+    NodoCarga* nodo = indiceNodos[entrada];
+    int desde = (int)(posicion - indiceInicios[entrada]);
+    int copiados = 0;
+    for (; nodo && copiados < n; nodo = nodo->siguiente) {
+        int tramo = nodo->usados - desde;
+        if (tramo > n - copiados) tramo = n - copiados;
+        std::memcpy(destino + copiados, nodo->datos() + desde, (size_t)tramo);
+        copiados += tramo;
+        desde = 0;
+    }
+    return copiados;
 }
 
 void ListaDeCarga::imprimirMensaje() {
+    // En modo streaming solo se muestra la ventana
+    int omitir = (sumidero && tamanio > ventana) ? tamanio - ventana : 0;
+    if (volcados > 0 || omitir > 0) std::cout << "...";
+    
     if (!cabeza) {
+        if (volcados > 0) return;
         std::cout << "[Lista vacia]" << std::endl;
         return;
     }
     
     NodoCarga* actual = cabeza;
     while (actual) {
-        std::cout << actual->dato;
+        if (omitir >= actual->usados) {
+            omitir -= actual->usados;
+        } else {
+            std::cout.write(actual->datos() + omitir, actual->usados - omitir);
+            omitir = 0;
+        }
         actual = actual->siguiente;
     }
-}
\ No newline at end of file
+}
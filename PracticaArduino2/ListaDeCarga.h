@@ -8,20 +8,75 @@
 #ifndef LISTA_DE_CARGA_H
 #define LISTA_DE_CARGA_H
 
+#include <cstddef>
+#include "SumideroCarga.h"
+#include "BuscadorPalabras.h"
+
 /**
  * @struct NodoCarga
  * @brief Nodo de la lista doblemente enlazada
+ * 
+ * Cada nodo guarda un bloque de caracteres consecutivos del mensaje. Con
+ * capacidad 1 es la lista clásica de un carácter por nodo; con capacidades
+ * mayores es una lista "desenrollada" en la que los enlaces se reparten
+ * entre muchos caracteres. El struct es solo la cabecera: los caracteres
+ * van a continuación, en la misma memoria que la lista reserva para el
+ * nodo (ver tamanioPara()), y no forman parte de ningún miembro.
  */
 struct NodoCarga {
-    char dato;              ///< Carácter decodificado
     NodoCarga* siguiente;   ///< Puntero al siguiente nodo
     NodoCarga* previo;      ///< Puntero al nodo anterior
+    int usados;             ///< Caracteres ocupados en este nodo
+    int capacidad;          ///< Caracteres que caben tras la cabecera
     
     /**
      * @brief Constructor del nodo
-     * @param c Carácter a almacenar
+     * @param c Primer carácter a almacenar
+     * @param capacidadNodo Caracteres reservados tras la cabecera
+     */
+    NodoCarga(char c, int capacidadNodo)
+        : siguiente(0), previo(0), usados(1), capacidad(capacidadNodo) {
+        datos()[0] = c;
+    }
+    
+    /**
+     * @brief Acceso a los caracteres del nodo
+     * @return Puntero al primer carácter; los demás son contiguos
+     */
+    char* datos() { return reinterpret_cast<char*>(this) + sizeof(NodoCarga); }
+    
+    /**
+     * @brief Bytes que ocupa un nodo con la capacidad indicada
+     * @param capacidad Caracteres por nodo
+     * @return Cabecera más caracteres, redondeado a la alineación de NodoCarga
      */
-    NodoCarga(char c) : dato(c), siguiente(0), previo(0) {}
+    static size_t tamanioPara(int capacidad) {
+        size_t bytes = sizeof(NodoCarga) + (size_t)capacidad;
+        size_t alineacion = alignof(NodoCarga);
+        return (bytes + alineacion - 1) / alineacion * alineacion;
+    }
+};
+
+/**
+ * @struct BloqueNodos
+ * @brief Bloque contiguo de memoria del que se recortan los nodos de la lista
+ * 
+ * Los nodos no se piden uno a uno con new: se toman en orden de un bloque
+ * y, al agotarse, se reserva el siguiente. Como se insertan al final, los
+ * nodos consecutivos del mensaje quedan contiguos en memoria.
+ */
+struct BloqueNodos {
+    static const size_t TAM_MEMORIA = 64 * 1024;    ///< Bytes de nodos por bloque
+    
+    BloqueNodos* siguiente;             ///< Bloque reservado antes que este
+    /// Memoria sin inicializar para los nodos
+    alignas(NodoCarga) unsigned char memoria[TAM_MEMORIA];
+    
+    /**
+     * @brief Constructor que encadena el bloque con los anteriores
+     * @param anterior Último bloque reservado, o 0
+     */
+    BloqueNodos(BloqueNodos* anterior) : siguiente(anterior) {}
 };
 
 /**
@@ -30,21 +85,87 @@ struct NodoCarga {
  * 
  * Esta lista mantiene el orden de llegada de los caracteres decodificados.
  * Se inserta siempre al final para preservar la secuencia del mensaje.
+ * 
+ * La capacidad de cada nodo se fija al construir la lista: 1 da la lista
+ * clásica; entre 64 y 4096 la memoria por carácter se acerca a 1 byte y
+ * el mensaje se imprime con una escritura por nodo.
+ * 
+ * Las consultas por posición usan un índice con el inicio de cada nodo,
+ * que se completa solo al consultar: insertar no cuesta más y cada
+ * consulta es una búsqueda binaria.
  */
 class ListaDeCarga {
 private:
     NodoCarga* cabeza;      ///< Primer nodo de la lista
     NodoCarga* cola;        ///< Último nodo de la lista
     int tamanio;            ///< Número de caracteres almacenados
+    int capacidadNodo;      ///< Caracteres que caben en cada nodo
+    size_t bytesNodo;       ///< Bytes que ocupa cada nodo en los bloques
+    
+    BloqueNodos* bloques;   ///< Bloque actual (encadena a los anteriores)
+    size_t usadosEnBloque;  ///< Bytes ya recortados del bloque actual
+    NodoCarga* libres;      ///< Nodos ya volcados, listos para reutilizarse
+    
+    SumideroCarga* sumidero; ///< Destino del mensaje antiguo, o 0 para retenerlo todo
+    int ventana;            ///< Caracteres finales que se retienen con sumidero
+    unsigned long long volcados; ///< Caracteres del mensaje actual ya entregados al sumidero
+    BuscadorPalabras* buscador; ///< Autómata que recibe cada carácter anexado, o 0
+    
+    NodoCarga** indiceNodos;    ///< Nodos indexados, en orden
+    unsigned long long* indiceInicios; ///< Posición en el mensaje del primer carácter de cada uno
+    int indiceUsados;           ///< Entradas válidas del índice
+    int indiceCapacidad;        ///< Entradas reservadas
+    
+    /**
+     * @brief Agrega al índice los nodos anexados desde la última consulta
+     */
+    void actualizarIndice();
+    
+    /**
+     * @brief Busca el nodo que contiene una posición
+     * @param posicion Posición en el mensaje
+     * @return Entrada del índice, o -1 si ya se volcó o no ha llegado
+     */
+    int buscarNodo(unsigned long long posicion);
+    
+    /**
+     * @brief Entrega al sumidero los nodos que sobran de la ventana
+     * 
+     * Solo se invoca cuando lo retenido supera la ventana en UMBRAL_VOLCADO
+     * caracteres, así que el volcado va por bloques grandes. Los nodos
+     * volcados pasan a 'libres' y la memoria se mantiene constante. Con
+     * buscador nunca se retienen menos de MAX_LONGITUD - 1 caracteres.
+     */
+    void recortar();
+    
+    /**
+     * @brief Obtiene memoria para un nodo nuevo del bloque actual
+     * @return Memoria sin inicializar de bytesNodo bytes
+     */
+    void* reservarNodo();
+    
+    /**
+     * @brief Agrega un nodo nuevo al final con un primer carácter
+     * @param dato Carácter inicial del nodo
+     */
+    void agregarNodo(char dato);
     
 public:
+    static const int CAPACIDAD_MAXIMA = 4096;   ///< Máximo de caracteres por nodo
+    static const int UMBRAL_VOLCADO = 16384;    ///< Exceso sobre la ventana que dispara un volcado
+    
     /**
      * @brief Constructor que inicializa una lista vacía
+     * @param capacidad Caracteres por nodo (1 = un carácter por nodo;
+     *        se ajusta al rango [1, CAPACIDAD_MAXIMA])
      */
-    ListaDeCarga();
+    ListaDeCarga(int capacidad = 1);
     
     /**
      * @brief Destructor que libera toda la memoria
+     * 
+     * Los nodos se liberan en bloque junto con la memoria de la que se
+     * recortaron; no hay un delete por carácter.
      */
     ~ListaDeCarga();
     
@@ -56,10 +177,124 @@ public:
      */
     void insertarAlFinal(char dato);
     
+    /**
+     * @brief Inserta varios caracteres al final de la lista
+     * @param datos Caracteres a insertar, en orden
+     * @param n Número de caracteres
+     * 
+     * Equivale a n llamadas a insertarAlFinal(), pero copia por tramos
+     * directamente en los nodos.
+     */
+    void insertarBloque(const char* datos, int n);
+    
+    /**
+     * @brief Activa el modo streaming
+     * @param destino Sumidero que recibe el mensaje antiguo (0 = retener todo)
+     * @param caracteres Caracteres finales que se conservan en la lista
+     * 
+     * La lista pasa a guardar solo el final del mensaje (para los
+     * diagnósticos "Mensaje: [...]"); el resto se entrega a 'destino' en
+     * orden. La memoria queda acotada sin importar el largo del mensaje.
+     * El sumidero no pasa a ser propiedad de la lista.
+     */
+    void setSumidero(SumideroCarga* destino, int caracteres);
+    
+    /**
+     * @brief Sumidero del modo streaming
+     * @return Sumidero configurado, o 0 si la lista retiene todo
+     */
+    SumideroCarga* getSumidero() const { return sumidero; }
+    
+    /**
+     * @brief Entrega al sumidero el mensaje actual completo y lo cierra
+     * 
+     * Vuelca también la ventana, marca el fin de mensaje en el sumidero y
+     * deja la lista vacía. Sin sumidero equivale a vaciar().
+     */
+    void cerrarMensaje();
+    
+    /**
+     * @brief Caracteres del mensaje actual entregados ya al sumidero
+     * @return 0 si la lista retiene todo el mensaje
+     */
+    unsigned long long getVolcados() const { return volcados; }
+    
+    /**
+     * @brief Activa la búsqueda de palabras vigiladas
+     * @param destino Buscador ya compilado (0 = ninguno); no pasa a ser propiedad
+     * 
+     * Cada carácter anexado se pasa al buscador con su posición en el
+     * mensaje; vaciar la lista lo reinicia. Si la lista ya tiene caracteres,
+     * el buscador se sincroniza con su final sin avisar de lo ya recibido.
+     */
+    void setBuscador(BuscadorPalabras* destino);
+    
+    /**
+     * @brief Longitud del mensaje actual, incluida la parte ya volcada
+     * @return Caracteres recibidos desde el último vaciado
+     */
+    unsigned long long getLongitudMensaje() const { return volcados + (unsigned long long)tamanio; }
+    
+    /**
+     * @brief Carácter en una posición del mensaje en O(log nodos)
+     * @param posicion Posición desde 0 (cuenta lo volcado al sumidero)
+     * @param c Recibe el carácter
+     * @return false si la posición ya se volcó o aún no ha llegado
+     */
+    bool obtenerCaracter(unsigned long long posicion, char& c);
+    
+    /**
+     * @brief Copia un tramo del mensaje
+     * @param posicion Posición del primer carácter
+     * @param destino Buffer de al menos n bytes
+     * @param n Caracteres pedidos
+     * @return Caracteres copiados (menos de n si el tramo no está retenido entero)
+     */
+    int copiarTramo(unsigned long long posicion, char* destino, int n);
+    
+    /**
+     * @brief Retoma un mensaje a medias guardado en una instantánea
+     * @param datos Caracteres que la lista retenía
+     * @param n Número de caracteres
+     * @param volcadosPrevios Caracteres del mensaje que ya estaban en el sumidero
+     * 
+     * La lista debe estar vacía. Las posiciones siguen contando desde el
+     * inicio del mensaje original. Si hay buscador, se sincroniza con lo
+     * retenido sin volver a avisar.
+     */
+    void reanudarMensaje(const char* datos, int n, unsigned long long volcadosPrevios);
+    
+    /**
+     * @brief Deja la lista vacía para empezar un mensaje nuevo
+     * 
+     * Conserva el bloque de memoria actual para los nodos del próximo
+     * mensaje y libera los demás, así que una sesión con muchos mensajes
+     * no acumula memoria.
+     */
+    void vaciar();
+    
+    /**
+     * @brief Mueve al final de esta lista todos los caracteres de otra
+     * @param otra Lista cuyo contenido se anexa; queda vacía
+     * 
+     * Si ambas listas usan la misma capacidad por nodo, los nodos y los
+     * bloques de memoria de 'otra' pasan a esta lista sin copiar caracteres
+     * (O(bloques)). Si no, los caracteres se copian por tramos.
+     */
+    void moverAlFinal(ListaDeCarga& otra);
+    
+    /**
+     * @brief Primer nodo, para recorrer el mensaje bloque a bloque
+     * @return Cabeza de la lista, o 0 si está vacía
+     */
+    NodoCarga* getPrimerNodo() { return cabeza; }
+    
     /**
      * @brief Imprime el mensaje completo ensamblado
      * 
-     * Recorre toda la lista e imprime cada carácter en orden.
+     * Recorre toda la lista e imprime cada nodo con una sola escritura.
+     * En modo streaming solo imprime la ventana, precedida de "..." si
+     * parte del mensaje ya se entregó al sumidero.
      */
     void imprimirMensaje();
     
@@ -69,6 +304,12 @@ public:
      */
     int getTamanio() const { return tamanio; }
     
+    /**
+     * @brief Obtiene la capacidad de cada nodo
+     * @return Caracteres por nodo
+     */
+    int getCapacidadNodo() const { return capacidadNodo; }
+    
     /**
      * @brief Verifica si la lista está vacía
      * @return true si no hay elementos, false en caso contrario
@@ -76,4 +317,4 @@ public:
     bool estaVacia() const { return cabeza == 0; }
 };
 
-#endif // LISTA_DE_CARGA_H
\ No newline at end of file
+#endif // LISTA_DE_CARGA_H
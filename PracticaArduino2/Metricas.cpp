@@ -0,0 +1,189 @@
+/**
+ * @file Metricas.cpp
+ * @brief Implementación de los histogramas y del volcado de métricas
+ */
+
+#include "Metricas.h"
+#include <chrono>
+#include <climits>
+#include <iostream>
+
+long long relojNs() {
+    long long ns = (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return ns != 0 ? ns : 1;
+}
+
+// ---------------------------------------------------------------------------
+// HistogramaLatencia
+// ---------------------------------------------------------------------------
+
+HistogramaLatencia::HistogramaLatencia() {
+    reiniciar();
+}
+
+void HistogramaLatencia::reiniciar() {
+    for (int i = 0; i < NUM_CUBETAS; i++) cuentas[i] = 0;
+    total = 0;
+    minimo = LLONG_MAX;
+    maximo = 0;
+    suma = 0.0;
+}
+
+int HistogramaLatencia::cubeta(unsigned long long valor) {
+    if (valor < (unsigned long long)SUBCUBETAS) return (int)valor;
+
+    // Posición del bit más alto (búsqueda binaria, sin intrínsecos)
+    int exponente = 0;
+    unsigned long long v = valor;
+    if (v >> 32) { v >>= 32; exponente += 32; }
+    if (v >> 16) { v >>= 16; exponente += 16; }
+    if (v >> 8)  { v >>= 8;  exponente += 8; }
+    if (v >> 4)  { v >>= 4;  exponente += 4; }
+    if (v >> 2)  { v >>= 2;  exponente += 2; }
+    if (v >> 1)  { exponente += 1; }
+
+    int sub = (int)(valor >> (exponente - BITS_SUBCUBETA)) - SUBCUBETAS;
+    return (exponente - BITS_SUBCUBETA + 1) * SUBCUBETAS + sub;
+}
+
+long long HistogramaLatencia::limiteSuperior(int indice) {
+    if (indice < SUBCUBETAS) return indice;
+
+    int exponente = indice / SUBCUBETAS + BITS_SUBCUBETA - 1;
+    unsigned long long sub = (unsigned long long)(indice % SUBCUBETAS);
+    unsigned long long limite = ((SUBCUBETAS + sub + 1) << (exponente - BITS_SUBCUBETA)) - 1;
+    return limite > (unsigned long long)LLONG_MAX ? LLONG_MAX : (long long)limite;
+}
+
+void HistogramaLatencia::registrar(long long ns, unsigned long long veces) {
+    if (veces == 0) return;
+    if (ns < 0) ns = 0;
+
+    cuentas[cubeta((unsigned long long)ns)] += veces;
+    total += veces;
+    suma += (double)ns * (double)veces;
+    if (ns < minimo) minimo = ns;
+    if (ns > maximo) maximo = ns;
+}
+
+long long HistogramaLatencia::percentil(double porcentaje) const {
+    if (total == 0) return 0;
+
+    // Posición (1..total) de la medición buscada
+    unsigned long long objetivo = (unsigned long long)(porcentaje / 100.0 * (double)total + 0.5);
+    if (objetivo < 1) objetivo = 1;
+    if (objetivo > total) objetivo = total;
+
+    unsigned long long acumulado = 0;
+    for (int i = 0; i < NUM_CUBETAS; i++) {
+        acumulado += cuentas[i];
+        if (acumulado >= objetivo) {
+            long long limite = limiteSuperior(i);
+            return limite < maximo ? limite : maximo;
+        }
+    }
+    return maximo;
+}
+
+void HistogramaLatencia::escribirJson(std::ostream& salida) const {
+    salida << "{\"n\":" << total
+           << ",\"min\":" << getMinimo()
+           << ",\"media\":" << (long long)(getMedia() + 0.5)
+           << ",\"p50\":" << percentil(50.0)
+           << ",\"p90\":" << percentil(90.0)
+           << ",\"p99\":" << percentil(99.0)
+           << ",\"p999\":" << percentil(99.9)
+           << ",\"max\":" << maximo << "}";
+}
+
+// ---------------------------------------------------------------------------
+// Metricas
+// ---------------------------------------------------------------------------
+
+Metricas::Metricas()
+    : lineas(0), cargas(0), mapeos(0), fines(0), errores(0), bytes(0),
+      inicioNs(relojNs()), ultimoVolcadoNs(0), lineasEnVolcado(0) {
+    ultimoVolcadoNs = inicioNs;
+}
+
+void Metricas::escribirJson(std::ostream& salida, const char* sesion) {
+    long long ahora = relojNs();
+    double intervalo = (double)(ahora - ultimoVolcadoNs) / 1e9;
+    double tasa = intervalo > 0.0 ? (double)(lineas - lineasEnVolcado) / intervalo : 0.0;
+
+    salida << "{";
+    if (sesion) {
+        // Los nombres de puerto no llevan comillas ni barras invertidas
+        salida << "\"sesion\":\"" << sesion << "\",";
+    }
+    salida << "\"segundos\":" << (double)(ahora - inicioNs) / 1e9
+           << ",\"tramas_s\":" << (long long)(tasa + 0.5)
+           << ",\"lineas\":" << lineas
+           << ",\"cargas\":" << cargas
+           << ",\"mapeos\":" << mapeos
+           << ",\"fines\":" << fines
+           << ",\"errores\":" << errores
+           << ",\"bytes\":" << bytes
+           << ",\"latencia_ns\":{\"espera\":";
+    espera.escribirJson(salida);
+    salida << ",\"parseo\":";
+    parseo.escribirJson(salida);
+    salida << ",\"procesar\":";
+    procesar.escribirJson(salida);
+    salida << ",\"total\":";
+    total.escribirJson(salida);
+    salida << "}}" << std::endl;
+
+    ultimoVolcadoNs = ahora;
+    lineasEnVolcado = lineas;
+}
+
+// ---------------------------------------------------------------------------
+// PublicadorMetricas
+// ---------------------------------------------------------------------------
+
+volatile std::sig_atomic_t& PublicadorMetricas::solicitado() {
+    static volatile std::sig_atomic_t bandera = 0;
+    return bandera;
+}
+
+void PublicadorMetricas::solicitar(int senal) {
+    (void)senal;
+    solicitado() = 1;
+}
+
+PublicadorMetricas::PublicadorMetricas()
+    : salida(0), intervaloNs(0), proximoNs(0) {}
+
+bool PublicadorMetricas::abrir(const char* ruta, int intervaloSegundos) {
+    if (ruta[0] == '-' && ruta[1] == '\0') {
+        salida = &std::cerr;
+    } else {
+        archivo.open(ruta, std::ios::out | std::ios::app);
+        if (!archivo) {
+            std::cerr << "Error: No se pudo abrir el archivo de metricas " << ruta << std::endl;
+            return false;
+        }
+        salida = &archivo;
+    }
+
+    intervaloNs = (long long)intervaloSegundos * 1000000000LL;
+    proximoNs = relojNs() + intervaloNs;
+    return true;
+}
+
+bool PublicadorMetricas::pendiente() const {
+    if (!salida) return false;
+    if (solicitado()) return true;
+    return intervaloNs > 0 && relojNs() >= proximoNs;
+}
+
+void PublicadorMetricas::publicar(Metricas& metricas, const char* sesion) {
+    if (salida) metricas.escribirJson(*salida, sesion);
+}
+
+void PublicadorMetricas::terminarRonda() {
+    solicitado() = 0;
+    if (intervaloNs > 0) proximoNs = relojNs() + intervaloNs;
+}
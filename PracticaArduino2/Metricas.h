@@ -0,0 +1,198 @@
+/**
+ * @file Metricas.h
+ * @brief Histogramas de latencia y contadores de rendimiento del decodificador
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <csignal>
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+
+/**
+ * @brief Instante actual de un reloj monótono
+ * @return Nanosegundos desde un origen arbitrario (nunca 0)
+ */
+long long relojNs();
+
+/**
+ * @class HistogramaLatencia
+ * @brief Histograma de tiempos con precisión relativa fija (estilo HDR)
+ *
+ * Cada potencia de dos se divide en SUBCUBETAS cubetas iguales, así que
+ * cualquier valor entre 1 ns y varios siglos se guarda con un error menor
+ * que 1/SUBCUBETAS (6.25 %) en un arreglo fijo, sin reservar memoria al
+ * registrar. Los valores menores que SUBCUBETAS son exactos.
+ */
+class HistogramaLatencia {
+public:
+    static const int BITS_SUBCUBETA = 4;                    ///< log2 de SUBCUBETAS
+    static const int SUBCUBETAS = 1 << BITS_SUBCUBETA;      ///< Cubetas por potencia de dos
+    static const int NUM_CUBETAS = (64 - BITS_SUBCUBETA) * SUBCUBETAS;  ///< Hasta 2^63 ns
+
+private:
+    unsigned long long cuentas[NUM_CUBETAS];    ///< Registros por cubeta
+    unsigned long long total;                   ///< Registros en total
+    long long minimo;                           ///< Menor valor registrado
+    long long maximo;                           ///< Mayor valor registrado
+    double suma;                                ///< Suma de los valores (para la media)
+
+    /**
+     * @brief Cubeta a la que pertenece un valor
+     */
+    static int cubeta(unsigned long long valor);
+
+    /**
+     * @brief Mayor valor que cae en una cubeta
+     */
+    static long long limiteSuperior(int indice);
+
+public:
+    /**
+     * @brief Constructor de un histograma vacío
+     */
+    HistogramaLatencia();
+
+    /**
+     * @brief Registra una medición
+     * @param ns Duración en nanosegundos (los negativos cuentan como 0)
+     * @param veces Número de mediciones con ese valor
+     */
+    void registrar(long long ns, unsigned long long veces = 1);
+
+    /**
+     * @brief Valor bajo el cual cae el porcentaje indicado de las mediciones
+     * @param porcentaje Entre 0 y 100
+     * @return Nanosegundos (límite superior de la cubeta), 0 si está vacío
+     */
+    long long percentil(double porcentaje) const;
+
+    /**
+     * @brief Olvida todas las mediciones
+     */
+    void reiniciar();
+
+    unsigned long long getTotal() const { return total; }
+    long long getMinimo() const { return total ? minimo : 0; }
+    long long getMaximo() const { return maximo; }
+    double getMedia() const { return total ? suma / (double)total : 0.0; }
+
+    /**
+     * @brief Escribe el resumen como objeto JSON
+     * @param salida Flujo de destino
+     *
+     * Formato: {"n":..,"min":..,"media":..,"p50":..,"p90":..,"p99":..,"p999":..,"max":..}
+     * con los tiempos en nanosegundos.
+     */
+    void escribirJson(std::ostream& salida) const;
+};
+
+/**
+ * @struct Metricas
+ * @brief Contadores y latencias de una sesión de decodificación
+ *
+ * El Decodificador la alimenta si se le asigna con setMetricas(); sin
+ * métricas no se lee el reloj en el camino caliente. Las etapas de una
+ * trama se miden desde que SerialReader leyó del puerto el byte que la
+ * completó.
+ */
+struct Metricas {
+    HistogramaLatencia espera;      ///< Lectura del puerto -> inicio del parseo
+    HistogramaLatencia parseo;      ///< parsearLinea()
+    HistogramaLatencia procesar;    ///< procesar() de MAP/FIN; decodificar e insertar las cargas
+    HistogramaLatencia total;       ///< Lectura del puerto -> trama aplicada a ListaDeCarga
+
+    unsigned long long lineas;      ///< Líneas recibidas (válidas o no)
+    unsigned long long cargas;      ///< Tramas LOAD
+    unsigned long long mapeos;      ///< Tramas MAP
+    unsigned long long fines;       ///< Tramas FIN
+    unsigned long long errores;     ///< Líneas rechazadas por el parser
+    unsigned long long bytes;       ///< Posición en el flujo tras la última línea
+
+    long long inicioNs;             ///< Creación (origen de "segundos")
+    long long ultimoVolcadoNs;      ///< Último escribirJson() (para la tasa del intervalo)
+    unsigned long long lineasEnVolcado; ///< 'lineas' en el último escribirJson()
+
+    /**
+     * @brief Constructor con todo a cero
+     */
+    Metricas();
+
+    /**
+     * @brief Escribe una línea JSON con el estado actual
+     * @param salida Flujo de destino
+     * @param sesion Nombre de la sesión, o 0 si solo hay una
+     *
+     * Además de los acumulados incluye "tramas_s", la tasa de líneas desde
+     * el volcado anterior. Los histogramas no se reinician.
+     */
+    void escribirJson(std::ostream& salida, const char* sesion);
+};
+
+/**
+ * @class PublicadorMetricas
+ * @brief Decide cuándo y dónde se vuelcan las métricas
+ *
+ * Se vuelca cuando llega SIGUSR2 (ver solicitar()), cada 'intervalo'
+ * segundos si se configuró, y al terminar. El destino es stderr ("-") o
+ * un archivo al que se añaden líneas.
+ */
+class PublicadorMetricas {
+    std::ofstream archivo;      ///< Destino si no es stderr
+    std::ostream* salida;       ///< Flujo de destino, o 0 si está desactivado
+    long long intervaloNs;      ///< Periodo de volcado (0 = solo a petición)
+    long long proximoNs;        ///< Próximo volcado periódico
+
+    /// Bandera que activa el manejador de señal
+    static volatile std::sig_atomic_t& solicitado();
+
+public:
+    /**
+     * @brief Constructor de un publicador desactivado
+     */
+    PublicadorMetricas();
+
+    /**
+     * @brief Activa el volcado
+     * @param ruta Archivo de destino, o "-" para stderr
+     * @param intervaloSegundos Periodo de volcado (0 = solo con señal y al final)
+     * @return false si no se pudo abrir el archivo
+     */
+    bool abrir(const char* ruta, int intervaloSegundos);
+
+    /**
+     * @brief Indica si el volcado está activo
+     */
+    bool activo() const { return salida != 0; }
+
+    /**
+     * @brief Indica si toca volcar (señal recibida o intervalo cumplido)
+     */
+    bool pendiente() const;
+
+    /**
+     * @brief Vuelca las métricas de una sesión
+     * @param metricas Métricas a escribir
+     * @param sesion Nombre de la sesión, o 0
+     */
+    void publicar(Metricas& metricas, const char* sesion = 0);
+
+    /**
+     * @brief Marca atendida la petición y programa el próximo volcado
+     *
+     * Se llama después de publicar() todas las sesiones de una ronda.
+     */
+    void terminarRonda();
+
+    /**
+     * @brief Manejador de SIGUSR2: solo marca la petición
+     * @param senal Número de señal (no se usa)
+     */
+    static void solicitar(int senal);
+};
+
+#endif // METRICAS_H
@@ -0,0 +1,262 @@
+/**
+ * @file Opciones.cpp
+ * @brief Implementación del análisis de la línea de comandos
+ */
+
+#include "Opciones.h"
+#include "ListaDeCarga.h"
+#include "BuscadorPalabras.h"
+#include "RotorDeMapeo.h"
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+bool parsearOpciones(int argc, char* argv[], Opciones& opciones) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        
+        // Todas las opciones reconocidas llevan un valor, salvo la ayuda
+        if (std::strcmp(arg, "--ayuda") == 0 || std::strcmp(arg, "-h") == 0) {
+            return false;
+        }
+        
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Falta el valor de la opcion " << arg << std::endl;
+            return false;
+        }
+        const char* valor = argv[++i];
+        
+        if (std::strcmp(arg, "--puerto") == 0) {
+            if (opciones.numPuertos == Opciones::MAX_PUERTOS) {
+                std::cerr << "Error: Se admiten como maximo " << Opciones::MAX_PUERTOS
+                          << " puertos" << std::endl;
+                return false;
+            }
+            opciones.puertos[opciones.numPuertos++] = valor;
+        } else if (std::strcmp(arg, "--input") == 0 || std::strcmp(arg, "--entrada") == 0) {
+            opciones.entrada = valor;
+        } else if (std::strcmp(arg, "--modo") == 0) {
+            if (std::strcmp(valor, "completo") == 0) {
+                opciones.modo = SALIDA_COMPLETA;
+            } else if (std::strcmp(valor, "fragmento") == 0) {
+                opciones.modo = SALIDA_FRAGMENTO;
+            } else if (std::strcmp(valor, "silencioso") == 0) {
+                opciones.modo = SALIDA_SILENCIOSA;
+            } else {
+                std::cerr << "Error: Modo desconocido: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--espera") == 0) {
+            opciones.esperaMs = std::atoi(valor);
+            if (opciones.esperaMs <= 0) {
+                std::cerr << "Error: La espera debe ser positiva: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--baudios") == 0) {
+            opciones.serial.baudios = std::atoi(valor);
+        } else if (std::strcmp(arg, "--crudo") == 0) {
+            if (std::strcmp(valor, "si") == 0) {
+                opciones.serial.modoCrudo = true;
+            } else if (std::strcmp(valor, "no") == 0) {
+                opciones.serial.modoCrudo = false;
+            } else {
+                std::cerr << "Error: --crudo espera 'si' o 'no': " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--formato") == 0) {
+            if (std::strcmp(valor, "auto") == 0) {
+                opciones.serial.formato = FORMATO_AUTO;
+            } else if (std::strcmp(valor, "texto") == 0) {
+                opciones.serial.formato = FORMATO_TEXTO;
+            } else if (std::strcmp(valor, "binario") == 0) {
+                opciones.serial.formato = FORMATO_BINARIO;
+            } else {
+                std::cerr << "Error: Formato desconocido: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--bloque") == 0) {
+            opciones.capacidadBloque = std::atoi(valor);
+            if (opciones.capacidadBloque < 1 ||
+                opciones.capacidadBloque > ListaDeCarga::CAPACIDAD_MAXIMA) {
+                std::cerr << "Error: El bloque debe estar entre 1 y "
+                          << ListaDeCarga::CAPACIDAD_MAXIMA << ": " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--hilos") == 0) {
+            opciones.hilos = std::atoi(valor);
+            if (opciones.hilos < 0 || opciones.hilos > 256) {
+                std::cerr << "Error: Los hilos deben estar entre 0 y 256: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--reiniciar-rotor") == 0) {
+            if (std::strcmp(valor, "si") == 0) {
+                opciones.reiniciarRotor = true;
+            } else if (std::strcmp(valor, "no") == 0) {
+                opciones.reiniciarRotor = false;
+            } else {
+                std::cerr << "Error: --reiniciar-rotor espera 'si' o 'no': " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--sumidero") == 0) {
+            opciones.sumidero = valor;
+        } else if (std::strcmp(arg, "--ventana") == 0) {
+            opciones.ventana = std::atoi(valor);
+            if (opciones.ventana < 0) {
+                std::cerr << "Error: La ventana no puede ser negativa: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--metricas") == 0) {
+            opciones.metricas = valor;
+        } else if (std::strcmp(arg, "--intervalo-metricas") == 0) {
+            opciones.intervaloMetricas = std::atoi(valor);
+            if (opciones.intervaloMetricas < 0) {
+                std::cerr << "Error: El intervalo de metricas no puede ser negativo: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--alfabeto") == 0) {
+            if (!RotorDeMapeo::buscarAlfabeto(valor, opciones.alfabeto, opciones.longitudAlfabeto)) {
+                std::cerr << "Error: Alfabeto invalido (minimo 2 simbolos, sin repetir): "
+                          << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--vigilar") == 0) {
+            if (opciones.numVigiladas == Opciones::MAX_VIGILADAS) {
+                std::cerr << "Error: Se admiten como maximo " << Opciones::MAX_VIGILADAS
+                          << " palabras vigiladas" << std::endl;
+                return false;
+            }
+            size_t longitud = std::strlen(valor);
+            if (longitud < 1 || longitud > (size_t)BuscadorPalabras::MAX_LONGITUD) {
+                std::cerr << "Error: La palabra vigilada debe tener de 1 a "
+                          << BuscadorPalabras::MAX_LONGITUD << " caracteres" << std::endl;
+                return false;
+            }
+            opciones.vigiladas[opciones.numVigiladas++] = valor;
+        } else if (std::strcmp(arg, "--instantanea") == 0) {
+            opciones.instantanea = valor;
+        } else if (std::strcmp(arg, "--intervalo-instantanea") == 0) {
+            opciones.intervaloInstantanea = std::atoi(valor);
+            if (opciones.intervaloInstantanea < 0) {
+                std::cerr << "Error: El intervalo de instantaneas no puede ser negativo: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--etapas") == 0) {
+            opciones.etapas = std::atoi(valor);
+            if (opciones.etapas < 1 || opciones.etapas > 3) {
+                std::cerr << "Error: Las etapas deben ser 1, 2 o 3: " << valor << std::endl;
+                return false;
+            }
+        } else {
+            std::cerr << "Error: Opcion desconocida: " << arg << std::endl;
+            return false;
+        }
+    }
+    
+    if (opciones.numPuertos > 0 && opciones.entrada) {
+        std::cerr << "Error: Use --puerto o --input, no ambos" << std::endl;
+        return false;
+    }
+    
+    if (opciones.etapas != 1 && (opciones.entrada || opciones.numPuertos > 1)) {
+        std::cerr << "Error: --etapas solo se admite con un unico puerto serial" << std::endl;
+        return false;
+    }
+    
+    if (opciones.numPuertos > 1 && opciones.sumidero && std::strcmp(opciones.sumidero, "-") == 0) {
+        std::cerr << "Error: Con varios puertos --sumidero debe ser un archivo" << std::endl;
+        return false;
+    }
+    
+    // Sin modo crudo la terminal traduciría bytes de las tramas binarias
+    if (opciones.serial.formato == FORMATO_BINARIO && !opciones.serial.modoCrudo) {
+        std::cerr << "Error: --formato binario requiere --crudo si" << std::endl;
+        return false;
+    }
+    
+    if (opciones.intervaloMetricas > 0 && !opciones.metricas) {
+        std::cerr << "Error: --intervalo-metricas requiere --metricas" << std::endl;
+        return false;
+    }
+    
+    if (opciones.metricas && opciones.hilos != 1) {
+        std::cerr << "Error: --metricas no se admite con --hilos" << std::endl;
+        return false;
+    }
+    
+    // Solo una sesión en un único hilo tiene un punto del flujo que guardar
+    if (opciones.instantanea && (opciones.hilos != 1 || opciones.etapas != 1 || opciones.numPuertos > 1)) {
+        std::cerr << "Error: --instantanea no se admite con --hilos, --etapas ni varios puertos" << std::endl;
+        return false;
+    }
+    
+    // La decodificación en paralelo no produce diagnóstico por trama
+    if (opciones.hilos != 1) {
+        if (!opciones.entrada) {
+            std::cerr << "Error: --hilos solo se admite con --input" << std::endl;
+            return false;
+        }
+        opciones.modo = SALIDA_SILENCIOSA;
+    }
+    
+    return true;
+}
+
+void mostrarAyuda(const char* programa) {
+    std::cout << "Uso: " << programa << " [opciones]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  --puerto NOMBRE   Puerto serial (ej. COM3 o /dev/ttyUSB0)." << std::endl;
+    std::cout << "                    Si se omite, se pregunta al iniciar. Puede repetirse" << std::endl;
+    std::cout << "                    (hasta 64) para decodificar varios transmisores a la vez," << std::endl;
+    std::cout << "                    cada uno con su propio rotor y mensaje." << std::endl;
+    std::cout << "  --input ARCHIVO   Decodifica una captura guardada en lugar del puerto" << std::endl;
+    std::cout << "                    (alias: --entrada). El archivo se proyecta en memoria." << std::endl;
+    std::cout << "  --modo MODO       Diagnostico por trama:" << std::endl;
+    std::cout << "                      completo   reimprime el mensaje en cada carga (por defecto)" << std::endl;
+    std::cout << "                      fragmento  solo el fragmento recien decodificado" << std::endl;
+    std::cout << "                      silencioso nada; el mensaje se imprime al final" << std::endl;
+    std::cout << "  --espera MS       Espera maxima sin datos antes de revisar senales" << std::endl;
+    std::cout << "                    (por defecto 1000 ms). No limita la latencia." << std::endl;
+    std::cout << "  --baudios N       Velocidad de la linea (9600 por defecto, hasta 921600)." << std::endl;
+    std::cout << "  --crudo si|no     Terminal en modo crudo, sin eco ni modo canonico (por defecto si)." << std::endl;
+    std::cout << "                    El puerto se abre no bloqueante y poll() decide cuando leer," << std::endl;
+    std::cout << "                    asi que VMIN y VTIME quedan en 0 (no son configurables)." << std::endl;
+    std::cout << "  --formato F       Protocolo de las tramas: auto (por defecto; se decide por el" << std::endl;
+    std::cout << "                    primer byte), texto (\"L,X\", \"M,N\", \"FIN\") o binario" << std::endl;
+    std::cout << "                    (PRT-7B: bloques de cargas, varint y CRC-8)." << std::endl;
+    std::cout << "  --alfabeto A      Simbolos del rotor: prt7 (A-Z y espacio, por defecto)," << std::endl;
+    std::cout << "                    digitos, minusculas (a-z y espacio), bytes (0-255) o" << std::endl;
+    std::cout << "                    cualquier otra cadena sin simbolos repetidos." << std::endl;
+    std::cout << "  --bloque N        Caracteres por nodo de la lista de carga (1-4096)." << std::endl;
+    std::cout << "                    1 = un caracter por nodo (por defecto); 64 o mas ahorra" << std::endl;
+    std::cout << "                    memoria en mensajes largos." << std::endl;
+    std::cout << "  --reiniciar-rotor si|no  Cada FIN cierra un mensaje; con 'si' el siguiente" << std::endl;
+    std::cout << "                    empieza con el rotor en 'A' (por defecto no)." << std::endl;
+    std::cout << "  --sumidero RUTA   Modo streaming: el mensaje se escribe en RUTA ('-' = consola)" << std::endl;
+    std::cout << "                    por bloques y en memoria solo queda el final. Con varios" << std::endl;
+    std::cout << "                    puertos cada sesion usa RUTA.N." << std::endl;
+    std::cout << "  --ventana N       Caracteres finales retenidos en modo streaming (por defecto 256)." << std::endl;
+    std::cout << "  --hilos N         Con --input, reparte la captura entre N hilos (0 = todos" << std::endl;
+    std::cout << "                    los nucleos; 1 = secuencial, por defecto). Implica" << std::endl;
+    std::cout << "                    --modo silencioso." << std::endl;
+    std::cout << "  --etapas N        Con el puerto, reparte el trabajo en hilos unidos por colas:" << std::endl;
+    std::cout << "                      1  todo en un hilo (por defecto)" << std::endl;
+    std::cout << "                      2  hilo lector + decodificacion" << std::endl;
+    std::cout << "                      3  ademas un hilo para la salida por consola" << std::endl;
+    std::cout << "                    Al terminar muestra en stderr la presion de cada cola." << std::endl;
+    std::cout << "  --metricas RUTA   Mide cada trama y vuelca contadores y latencias (ns) como" << std::endl;
+    std::cout << "                    una linea JSON en RUTA ('-' = stderr): al recibir SIGUSR2," << std::endl;
+    std::cout << "                    cada --intervalo-metricas segundos y al terminar." << std::endl;
+    std::cout << "  --intervalo-metricas S  Segundos entre volcados (0 = solo a peticion, por defecto)." << std::endl;
+    std::cout << "  --vigilar PALABRA Avisa en stderr de cada aparicion de PALABRA en el mensaje," << std::endl;
+    std::cout << "                    con su posicion. Puede repetirse (hasta 64); todas se" << std::endl;
+    std::cout << "                    buscan a la vez sin volver a recorrer el mensaje." << std::endl;
+    std::cout << "  --instantanea RUTA  Guarda en RUTA el rotor, el mensaje a medias y la posicion" << std::endl;
+    std::cout << "                    en el flujo. Si RUTA ya existe, se reanuda desde ella: con" << std::endl;
+    std::cout << "                    --input solo se leen las tramas posteriores." << std::endl;
+    std::cout << "  --intervalo-instantanea S  Segundos entre instantaneas (por defecto 10;" << std::endl;
+    std::cout << "                    0 = solo al terminar el flujo)." << std::endl;
+    std::cout << "  --ayuda, -h       Muestra esta ayuda." << std::endl;
+    std::cout << std::endl;
+    std::cout << "En Linux/Mac, la senal SIGUSR1 imprime el mensaje acumulado sin detener" << std::endl;
+    std::cout << "la decodificacion, y SIGUSR2 vuelca las metricas si se activaron." << std::endl;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file Opciones.h
+ * @brief Opciones de línea de comandos del decodificador
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef OPCIONES_H
+#define OPCIONES_H
+
+#include "TramaBase.h"
+#include "SerialReader.h"
+
+/**
+ * @struct Opciones
+ * @brief Configuración elegida por el usuario al lanzar el programa
+ */
+struct Opciones {
+    static const int MAX_PUERTOS = 64;  ///< Sesiones simultáneas admitidas
+    static const int MAX_VIGILADAS = 64; ///< Palabras de --vigilar admitidas
+    
+    const char* puertos[MAX_PUERTOS]; ///< Puertos (o archivos) de --puerto, en orden
+    int numPuertos;         ///< Puertos indicados; 0 = preguntarlo por consola
+    const char* entrada;    ///< Captura a decodificar offline, o 0 para usar el puerto
+    ModoSalida modo;        ///< Nivel de diagnóstico por trama
+    int esperaMs;           ///< Espera máxima sin datos antes de revisar señales (ms)
+    ConfiguracionSerial serial; ///< Velocidad y modo de la línea serial
+    int capacidadBloque;    ///< Caracteres por nodo de ListaDeCarga (1 = lista clásica)
+    int hilos;              ///< Hilos para decodificar 'entrada' (1 = secuencial, 0 = todos los núcleos)
+    int etapas;             ///< Etapas en hilos para el puerto (1 = un solo hilo, 2 o 3)
+    bool reiniciarRotor;    ///< Si cada FIN devuelve el rotor a su posición inicial
+    const char* sumidero;   ///< Archivo del modo streaming ("-" = consola), o 0 para retener todo
+    int ventana;            ///< Caracteres que se retienen en modo streaming
+    const char* metricas;   ///< Destino de las métricas ("-" = stderr), o 0 para no medir
+    int intervaloMetricas;  ///< Segundos entre volcados de métricas (0 = solo a petición)
+    const char* alfabeto;   ///< Símbolos del rotor, o 0 para A-Z y espacio
+    int longitudAlfabeto;   ///< Número de símbolos de 'alfabeto'
+    const char* vigiladas[MAX_VIGILADAS]; ///< Palabras de --vigilar, en orden
+    int numVigiladas;       ///< Palabras vigiladas; 0 = sin búsqueda
+    const char* instantanea; ///< Archivo de instantáneas para reanudar, o 0
+    int intervaloInstantanea; ///< Segundos entre instantáneas (0 = solo al final)
+    
+    /**
+     * @brief Constructor con los valores por defecto del programa original
+     */
+    Opciones()
+        : numPuertos(0), entrada(0), modo(SALIDA_COMPLETA), esperaMs(1000),
+          capacidadBloque(1), hilos(1), etapas(1), reiniciarRotor(false),
+          sumidero(0), ventana(256), metricas(0), intervaloMetricas(0),
+          alfabeto(0), longitudAlfabeto(0), numVigiladas(0),
+          instantanea(0), intervaloInstantanea(10) {}
+};
+
+/**
+ * @brief Interpreta los argumentos de la línea de comandos
+ * @param argc Número de argumentos
+ * @param argv Argumentos recibidos por main
+ * @param opciones Estructura donde se guardan las opciones reconocidas
+ * @return true si los argumentos son válidos, false si hay que mostrar la ayuda
+ * 
+ * Ejemplo: decodificador --puerto /dev/ttyUSB0 --modo silencioso
+ * --puerto puede repetirse para decodificar varios transmisores a la vez.
+ */
+bool parsearOpciones(int argc, char* argv[], Opciones& opciones);
+
+/**
+ * @brief Muestra la ayuda de uso del programa
+ * @param programa Nombre con el que se invocó el ejecutable
+ */
+void mostrarAyuda(const char* programa);
+
+#endif // OPCIONES_H
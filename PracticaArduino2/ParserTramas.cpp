@@ -0,0 +1,158 @@
+/**
+ * @file ParserTramas.cpp
+ * @brief Implementación del parser de tramas PRT-7
+ */
+
+#include "ParserTramas.h"
+#include "ProtocoloBinario.h"
+#include <climits>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+    #define PARSER_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+ErrorParseo parsearLinea(const char* linea, size_t longitud, TramaParseada& trama) {
+    // Marca de fin de mensaje
+    if (longitud == 3 && linea[0] == 'F' && linea[1] == 'I' && linea[2] == 'N') {
+        trama.tipo = TRAMA_FIN;
+        return PARSEO_OK;
+    }
+    
+    // Debe haber un tipo y una coma
+    if (longitud < 2 || linea[1] != ',') {
+        // Restos de una trama binaria (SerialReader los entrega así)
+        if (longitud >= 1 && (unsigned char)linea[0] == SYNC_BINARIO) return ERROR_BINARIO_CORRUPTO;
+        if (longitud >= 1 && linea[0] != 'L' && linea[0] != 'M') return ERROR_TIPO_DESCONOCIDO;
+        return ERROR_FALTA_COMA;
+    }
+    
+    // El dato está después de la coma
+    const char* dato = linea + 2;
+    size_t largoDato = longitud - 2;
+    
+    if (linea[0] == 'L') {
+        // Trama de carga: L,X
+        if (largoDato == 0) return ERROR_CARGA_SIN_CARACTER;
+        
+        if (largoDato == 1) {
+            trama.caracter = dato[0];
+        } else if (largoDato == 5 && dato[0] == 'S' && dato[1] == 'p' &&
+                   dato[2] == 'a' && dato[3] == 'c' && dato[4] == 'e') {
+            // Caso especial del espacio: "L,Space"
+            trama.caracter = ' ';
+        } else {
+            return ERROR_CARGA_INVALIDA;
+        }
+        
+        trama.tipo = TRAMA_CARGA;
+        return PARSEO_OK;
+    }
+    
+    if (linea[0] == 'M') {
+        // Trama de mapeo: M,N
+        if (largoDato == 0) return ERROR_MAPEO_SIN_VALOR;
+        
+        size_t i = 0;
+        bool negativo = false;
+        if (dato[0] == '-' || dato[0] == '+') {
+            negativo = dato[0] == '-';
+            i++;
+        }
+        if (i == largoDato) return ERROR_MAPEO_SIN_VALOR;
+        
+        // Acumular en positivo con el límite del signo correspondiente
+        unsigned long long limite = negativo ? (unsigned long long)INT_MAX + 1
+                                             : (unsigned long long)INT_MAX;
+        unsigned long long valor = 0;
+        for (; i < largoDato; i++) {
+            if (dato[i] < '0' || dato[i] > '9') return ERROR_MAPEO_INVALIDO;
+            valor = valor * 10 + (unsigned long long)(dato[i] - '0');
+            if (valor > limite) return ERROR_MAPEO_DESBORDADO;
+        }
+        
+        trama.tipo = TRAMA_MAPEO;
+        trama.rotacion = negativo ? (int)(-(long long)valor) : (int)valor;
+        return PARSEO_OK;
+    }
+    
+    return ERROR_TIPO_DESCONOCIDO;
+}
+
+const char* describirError(ErrorParseo error) {
+    switch (error) {
+        case PARSEO_OK:                 return "Sin error";
+        case ERROR_FALTA_COMA:          return "Formato invalido (falta coma)";
+        case ERROR_CARGA_SIN_CARACTER:  return "Trama LOAD sin caracter";
+        case ERROR_CARGA_INVALIDA:      return "Trama LOAD con mas de un caracter";
+        case ERROR_MAPEO_SIN_VALOR:     return "Trama MAP sin valor";
+        case ERROR_MAPEO_INVALIDO:      return "Trama MAP con valor no numerico";
+        case ERROR_MAPEO_DESBORDADO:    return "Trama MAP con valor fuera de rango";
+        case ERROR_TIPO_DESCONOCIDO:    return "Tipo de trama desconocido";
+        case ERROR_BINARIO_CORRUPTO:    return "Trama binaria corrupta o incompleta";
+    }
+    return "Error desconocido";
+}
+
+const char* buscarFinDeLinea(const char* inicio, const char* fin) {
+    const char* p = inicio;
+    
+#ifdef PARSER_SSE2
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (fin - p >= 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        int mascara = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, lf),
+                                                     _mm_cmpeq_epi8(x, cr)));
+        if (mascara) {
+            // El bit más bajo encendido es el primer terminador
+            int indice = 0;
+            while (!(mascara & 1)) {
+                mascara >>= 1;
+                indice++;
+            }
+            return p + indice;
+        }
+        p += 16;
+    }
+#endif
+    
+    for (; p < fin; p++) {
+        if (*p == '\n' || *p == '\r') return p;
+    }
+    return fin;
+}
+
+size_t tokenizarTramas(const char* datos, size_t n, unsigned long long offsetBase,
+                       ReceptorTramas& receptor, bool esFinal) {
+    const char* fin = datos + n;
+    const char* actual = datos;
+    
+    while (actual < fin) {
+        // Ignorar CR/LF al inicio
+        if (*actual == '\n' || *actual == '\r') {
+            actual++;
+            continue;
+        }
+        
+        const char* terminador = buscarFinDeLinea(actual, fin);
+        
+        // Línea incompleta: se deja para la siguiente llamada
+        if (terminador == fin && !esFinal) break;
+        
+        size_t longitud = terminador - actual;
+        unsigned long long offset = offsetBase + (actual - datos);
+        
+        TramaParseada trama;
+        ErrorParseo error = parsearLinea(actual, longitud, trama);
+        if (error == PARSEO_OK) {
+            receptor.alRecibirTrama(trama, actual, longitud, offset);
+        } else {
+            receptor.alErrorParseo(error, actual, longitud, offset);
+        }
+        
+        actual = terminador;
+    }
+    
+    return actual - datos;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file ParserTramas.h
+ * @brief Parser validante y sin copias para el protocolo PRT-7 en texto
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef PARSER_TRAMAS_H
+#define PARSER_TRAMAS_H
+
+#include <cstddef>
+
+/**
+ * @enum TipoTrama
+ * @brief Clase de trama reconocida por el parser
+ */
+enum TipoTrama {
+    TRAMA_CARGA,    ///< "L,X": fragmento de datos
+    TRAMA_MAPEO,    ///< "M,N": rotación del rotor
+    TRAMA_FIN       ///< "FIN": fin del mensaje actual
+};
+
+/**
+ * @enum ErrorParseo
+ * @brief Resultado del análisis de una línea
+ */
+enum ErrorParseo {
+    PARSEO_OK = 0,              ///< Línea válida
+    ERROR_FALTA_COMA,           ///< El segundo carácter no es ','
+    ERROR_CARGA_SIN_CARACTER,   ///< "L," sin dato
+    ERROR_CARGA_INVALIDA,       ///< El dato de LOAD no es un carácter ni "Space"
+    ERROR_MAPEO_SIN_VALOR,      ///< "M," sin número
+    ERROR_MAPEO_INVALIDO,       ///< El valor de MAP contiene algo que no es un dígito
+    ERROR_MAPEO_DESBORDADO,     ///< El valor de MAP no cabe en un int
+    ERROR_TIPO_DESCONOCIDO,     ///< No es LOAD ('L'), MAP ('M') ni "FIN"
+    ERROR_BINARIO_CORRUPTO      ///< Trama PRT-7B inválida o bytes fuera de una trama
+};
+
+/**
+ * @struct TramaParseada
+ * @brief Trama ya validada, como valor (sin reservar memoria)
+ */
+struct TramaParseada {
+    TipoTrama tipo;     ///< Tipo de trama
+    char caracter;      ///< Carácter sin decodificar (solo TRAMA_CARGA)
+    int rotacion;       ///< Posiciones a rotar (solo TRAMA_MAPEO)
+};
+
+/**
+ * @class ReceptorTramas
+ * @brief Interfaz que recibe las tramas encontradas por tokenizarTramas()
+ * 
+ * Las líneas se entregan como vistas sobre el buffer original: solo son
+ * válidas durante la llamada.
+ */
+class ReceptorTramas {
+public:
+    /**
+     * @brief Destructor virtual para uso polimórfico
+     */
+    virtual ~ReceptorTramas() {}
+    
+    /**
+     * @brief Se invoca por cada línea válida
+     * @param trama Trama ya interpretada
+     * @param linea Texto de la línea (sin CR/LF)
+     * @param longitud Bytes de la línea
+     * @param offset Posición del primer byte de la línea en el flujo
+     */
+    virtual void alRecibirTrama(const TramaParseada& trama, const char* linea,
+                                size_t longitud, unsigned long long offset) = 0;
+    
+    /**
+     * @brief Se invoca por cada línea que no se pudo interpretar
+     * @param error Motivo del rechazo
+     * @param linea Texto de la línea (sin CR/LF)
+     * @param longitud Bytes de la línea
+     * @param offset Posición del primer byte de la línea en el flujo
+     */
+    virtual void alErrorParseo(ErrorParseo error, const char* linea,
+                               size_t longitud, unsigned long long offset) = 0;
+};
+
+/**
+ * @brief Interpreta una línea PRT-7
+ * @param linea Inicio de la línea (no necesita terminar en '\0')
+ * @param longitud Bytes de la línea, sin CR/LF
+ * @param trama Donde se escribe el resultado si la línea es válida
+ * @return PARSEO_OK o el motivo del rechazo
+ * 
+ * Formatos aceptados: "L,X" con X un único carácter, "L,Space", y "M,N"
+ * con N un entero decimal con signo opcional que quepa en un int.
+ * No reserva memoria ni escribe en la línea.
+ */
+ErrorParseo parsearLinea(const char* linea, size_t longitud, TramaParseada& trama);
+
+/**
+ * @brief Describe un error de parseo para mostrarlo al usuario
+ * @param error Código de error
+ * @return Mensaje estático en texto
+ */
+const char* describirError(ErrorParseo error);
+
+/**
+ * @brief Busca el siguiente fin de línea ('\n' o '\r')
+ * @param inicio Primer byte a revisar
+ * @param fin Uno después del último byte a revisar
+ * @return Puntero al terminador, o 'fin' si no hay ninguno
+ * 
+ * En x86 compara 16 bytes por instrucción con SSE2.
+ */
+const char* buscarFinDeLinea(const char* inicio, const char* fin);
+
+/**
+ * @brief Recorre un buffer completo de tramas en una sola pasada
+ * @param datos Inicio del buffer
+ * @param n Bytes en el buffer
+ * @param offsetBase Posición de datos[0] dentro del flujo (para los errores)
+ * @param receptor Destino de las tramas y errores encontrados
+ * @param esFinal true si no llegarán más bytes después del buffer
+ * @return Bytes consumidos. Si esFinal es false, la última línea sin
+ *         terminador no se consume y debe volver a pasarse con más datos.
+ * 
+ * Las líneas vacías (CR/LF repetidos) se ignoran, igual que en SerialReader.
+ */
+size_t tokenizarTramas(const char* datos, size_t n, unsigned long long offsetBase,
+                       ReceptorTramas& receptor, bool esFinal);
+
+#endif // PARSER_TRAMAS_H
@@ -0,0 +1,292 @@
+/**
+ * @file ProtocoloBinario.cpp
+ * @brief Implementación del formato binario PRT-7B
+ */
+
+#include "ProtocoloBinario.h"
+#include <cstring>
+
+namespace {
+
+/**
+ * @struct TablaCrc8
+ * @brief CRC-8 (polinomio 0x07) precalculado por byte
+ */
+struct TablaCrc8 {
+    unsigned char valores[256];     ///< CRC de cada byte partiendo de 0
+
+    TablaCrc8() {
+        for (int i = 0; i < 256; i++) {
+            unsigned char crc = (unsigned char)i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (unsigned char)((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+            }
+            valores[i] = crc;
+        }
+    }
+};
+
+/**
+ * @brief CRC-8 de un bloque de bytes
+ */
+unsigned char calcularCrc8(const unsigned char* datos, size_t n) {
+    static const TablaCrc8 tabla;
+    unsigned char crc = 0;
+    for (size_t i = 0; i < n; i++) crc = tabla.valores[crc ^ datos[i]];
+    return crc;
+}
+
+/**
+ * @brief Escribe un int como varint zigzag
+ * @return Bytes escritos (1 a 5)
+ */
+size_t escribirVarint(int valor, unsigned char* destino) {
+    // zigzag: 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+    unsigned int v = ((unsigned int)valor << 1) ^ (unsigned int)(valor < 0 ? -1 : 0);
+    size_t n = 0;
+    while (v >= 0x80) {
+        destino[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    destino[n++] = (unsigned char)v;
+    return n;
+}
+
+/**
+ * @brief Entrega una trama binaria a un ReceptorTramas como tramas de texto
+ * @param binaria Trama decodificada
+ * @param offset Posición de la trama en el flujo
+ * @param receptor Destino (una llamada por carga)
+ */
+void entregarTrama(const TramaBinaria& binaria, unsigned long long offset,
+                   ReceptorTramas& receptor) {
+    TramaParseada trama;
+    char linea[16];
+
+    if (binaria.tipo != TRAMA_CARGA) {
+        trama.tipo = binaria.tipo;
+        trama.rotacion = binaria.rotacion;
+        size_t longitud = escribirLineaTexto(trama, linea);
+        receptor.alRecibirTrama(trama, linea, longitud, offset);
+        return;
+    }
+
+    trama.tipo = TRAMA_CARGA;
+    for (int i = 0; i < binaria.numCargas; i++) {
+        trama.caracter = binaria.racha ? binaria.cargas[0] : binaria.cargas[i];
+        size_t longitud = escribirLineaTexto(trama, linea);
+        receptor.alRecibirTrama(trama, linea, longitud, offset);
+    }
+}
+
+} // namespace
+
+long decodificarTramaBinaria(const char* datos, size_t n, TramaBinaria& trama) {
+    const unsigned char* b = (const unsigned char*)datos;
+    if (n < 3) return n > 0 && b[0] != SYNC_BINARIO ? -1 : 0;
+    if (b[0] != SYNC_BINARIO) return -1;
+
+    size_t fin;     // Posición del crc
+    unsigned char etiqueta = b[1];
+
+    if (etiqueta == ETIQUETA_CARGAS || etiqueta == ETIQUETA_RACHA) {
+        int cantidad = b[2];
+        if (cantidad == 0) return -1;
+        fin = 3 + (etiqueta == ETIQUETA_CARGAS ? (size_t)cantidad : 1);
+        if (n <= fin) return 0;
+
+        trama.tipo = TRAMA_CARGA;
+        trama.cargas = datos + 3;
+        trama.numCargas = cantidad;
+        trama.racha = etiqueta == ETIQUETA_RACHA;
+    } else if (etiqueta == ETIQUETA_MAPEO) {
+        // Varint de hasta 5 bytes; el quinto solo aporta 4 bits
+        unsigned int v = 0;
+        size_t i = 2;
+        for (int desplazamiento = 0; ; desplazamiento += 7) {
+            if (i >= n) return 0;
+            if (desplazamiento == 28 && (b[i] & 0xF0)) return -1;
+            v |= (unsigned int)(b[i] & 0x7F) << desplazamiento;
+            if (!(b[i++] & 0x80)) break;
+        }
+        fin = i;
+        if (n <= fin) return 0;
+
+        trama.tipo = TRAMA_MAPEO;
+        trama.rotacion = (int)(v >> 1) ^ -(int)(v & 1);
+    } else if (etiqueta == ETIQUETA_FIN) {
+        fin = 2;
+        trama.tipo = TRAMA_FIN;
+    } else {
+        return -1;
+    }
+
+    if (calcularCrc8(b + 1, fin - 1) != b[fin]) return -1;
+    return (long)(fin + 1);
+}
+
+size_t escribirLineaTexto(const TramaParseada& trama, char* destino) {
+    if (trama.tipo == TRAMA_FIN) {
+        std::memcpy(destino, "FIN", 3);
+        return 3;
+    }
+
+    if (trama.tipo == TRAMA_CARGA) {
+        if (trama.caracter == ' ') {
+            std::memcpy(destino, "L,Space", 7);
+            return 7;
+        }
+        destino[0] = 'L';
+        destino[1] = ',';
+        destino[2] = trama.caracter;
+        return 3;
+    }
+
+    // M,N en decimal
+    size_t n = 0;
+    destino[n++] = 'M';
+    destino[n++] = ',';
+    unsigned long long magnitud;
+    if (trama.rotacion < 0) {
+        destino[n++] = '-';
+        magnitud = (unsigned long long)(-(long long)trama.rotacion);
+    } else {
+        magnitud = (unsigned long long)trama.rotacion;
+    }
+
+    char digitos[12];
+    int k = 0;
+    do {
+        digitos[k++] = (char)('0' + magnitud % 10);
+        magnitud /= 10;
+    } while (magnitud > 0);
+    while (k > 0) destino[n++] = digitos[--k];
+    return n;
+}
+
+size_t tokenizarTramasBinarias(const char* datos, size_t n, unsigned long long offsetBase,
+                               ReceptorTramas& receptor, bool esFinal) {
+    size_t p = 0;
+
+    while (p < n) {
+        unsigned char c = (unsigned char)datos[p];
+        if (c == '\n' || c == '\r') {
+            p++;
+            continue;
+        }
+
+        if (c != SYNC_BINARIO) {
+            // Bytes sueltos: un solo error por tramo hasta el siguiente SYNC
+            size_t inicio = p;
+            while (p < n && (unsigned char)datos[p] != SYNC_BINARIO) p++;
+            receptor.alErrorParseo(ERROR_BINARIO_CORRUPTO, datos + inicio, p - inicio,
+                                   offsetBase + inicio);
+            continue;
+        }
+
+        TramaBinaria trama;
+        long r = decodificarTramaBinaria(datos + p, n - p, trama);
+        if (r == 0) {
+            // Trama incompleta: esperar más bytes o, al final, reportarla
+            if (!esFinal) break;
+            receptor.alErrorParseo(ERROR_BINARIO_CORRUPTO, datos + p, n - p, offsetBase + p);
+            p = n;
+            break;
+        }
+        if (r < 0) {
+            // Saltar este SYNC y buscar el siguiente
+            receptor.alErrorParseo(ERROR_BINARIO_CORRUPTO, datos + p, 1, offsetBase + p);
+            p++;
+            continue;
+        }
+
+        entregarTrama(trama, offsetBase + p, receptor);
+        p += (size_t)r;
+    }
+
+    return p;
+}
+
+// ---------------------------------------------------------------------------
+// CodificadorBinario
+// ---------------------------------------------------------------------------
+
+CodificadorBinario::CodificadorBinario(char* salida)
+    : destino(salida), usados(0), numPendientes(0), descartadas(0) {}
+
+void CodificadorBinario::escribirTrama(unsigned char etiqueta, const unsigned char* contenido,
+                                       size_t n) {
+    unsigned char* salida = (unsigned char*)destino + usados;
+    salida[0] = SYNC_BINARIO;
+    salida[1] = etiqueta;
+    if (n > 0) std::memcpy(salida + 2, contenido, n);
+    salida[2 + n] = calcularCrc8(salida + 1, n + 1);
+    usados += n + 3;
+}
+
+void CodificadorBinario::alRecibirTrama(const TramaParseada& trama, const char* linea,
+                                        size_t longitud, unsigned long long offset) {
+    (void)linea; (void)longitud; (void)offset;
+
+    if (trama.tipo == TRAMA_CARGA) {
+        pendientes[numPendientes++] = trama.caracter;
+        if (numPendientes == MAX_CARGAS_BINARIAS) vaciar();
+        return;
+    }
+
+    vaciar();
+    if (trama.tipo == TRAMA_MAPEO) {
+        unsigned char varint[5];
+        escribirTrama(ETIQUETA_MAPEO, varint, escribirVarint(trama.rotacion, varint));
+    } else {
+        escribirTrama(ETIQUETA_FIN, 0, 0);
+    }
+}
+
+void CodificadorBinario::alErrorParseo(ErrorParseo error, const char* linea,
+                                       size_t longitud, unsigned long long offset) {
+    (void)error; (void)linea; (void)longitud; (void)offset;
+    descartadas++;
+}
+
+void CodificadorBinario::vaciar() {
+    const int RACHA_MINIMA = 4;
+    unsigned char contenido[MAX_CARGAS_BINARIAS + 1];
+
+    // Se alternan tramos sueltos y rachas de RACHA_MINIMA o más iguales
+    int i = 0;
+    int sueltos = 0;    // Inicio del tramo suelto en curso
+    while (i < numPendientes) {
+        int j = i + 1;
+        while (j < numPendientes && pendientes[j] == pendientes[i]) j++;
+
+        if (j - i >= RACHA_MINIMA) {
+            if (i > sueltos) {
+                contenido[0] = (unsigned char)(i - sueltos);
+                std::memcpy(contenido + 1, pendientes + sueltos, (size_t)(i - sueltos));
+                escribirTrama(ETIQUETA_CARGAS, contenido, (size_t)(i - sueltos) + 1);
+            }
+            contenido[0] = (unsigned char)(j - i);
+            contenido[1] = (unsigned char)pendientes[i];
+            escribirTrama(ETIQUETA_RACHA, contenido, 2);
+            sueltos = j;
+        }
+        i = j;
+    }
+
+    if (numPendientes > sueltos) {
+        contenido[0] = (unsigned char)(numPendientes - sueltos);
+        std::memcpy(contenido + 1, pendientes + sueltos, (size_t)(numPendientes - sueltos));
+        escribirTrama(ETIQUETA_CARGAS, contenido, (size_t)(numPendientes - sueltos) + 1);
+    }
+    numPendientes = 0;
+}
+
+size_t convertirABinario(const char* texto, size_t n, char* destino,
+                         unsigned long long* descartadas) {
+    CodificadorBinario codificador(destino);
+    tokenizarTramas(texto, n, 0, codificador, true);
+    codificador.vaciar();
+    if (descartadas) *descartadas = codificador.getDescartadas();
+    return codificador.getUsados();
+}
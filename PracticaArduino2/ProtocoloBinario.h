@@ -0,0 +1,168 @@
+/**
+ * @file ProtocoloBinario.h
+ * @brief Codificación binaria compacta de las tramas PRT-7
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ *
+ * Formato de cada trama (PRT-7B):
+ *
+ *     SYNC_BINARIO  etiqueta  contenido  crc
+ *
+ * - ETIQUETA_CARGAS: n (1-255) y n caracteres sin decodificar.
+ * - ETIQUETA_RACHA: n (1-255) y un carácter que se repite n veces.
+ * - ETIQUETA_MAPEO: rotación en varint zigzag (1 a 5 bytes).
+ * - ETIQUETA_FIN: sin contenido.
+ *
+ * El crc es CRC-8 (polinomio 0x07) de la etiqueta y el contenido. El byte
+ * de sincronía nunca aparece en el protocolo de texto, así que el primer
+ * byte del flujo basta para distinguir ambos formatos, y tras un error se
+ * retoma en el siguiente SYNC_BINARIO.
+ *
+ * Un bloque de 255 cargas ocupa 259 bytes frente a los 1275 o más de
+ * "L,X\r\n": a 9600 baudios se pasa de unos 190 a unos 940 caracteres por
+ * segundo (más con rachas).
+ */
+
+#ifndef PROTOCOLO_BINARIO_H
+#define PROTOCOLO_BINARIO_H
+
+#include <cstddef>
+#include "ParserTramas.h"
+
+/// Primer byte de toda trama binaria (no es ASCII, no aparece en texto)
+const unsigned char SYNC_BINARIO = 0xA5;
+
+/// Etiquetas de trama
+const unsigned char ETIQUETA_CARGAS = 0x01;
+const unsigned char ETIQUETA_RACHA = 0x02;
+const unsigned char ETIQUETA_MAPEO = 0x03;
+const unsigned char ETIQUETA_FIN = 0x04;
+
+/// Cargas como máximo en una trama
+const int MAX_CARGAS_BINARIAS = 255;
+
+/// Bytes máximos de una trama (SYNC + etiqueta + n + 255 cargas + crc)
+const size_t MAX_TRAMA_BINARIA = 259;
+
+/**
+ * @enum FormatoTramas
+ * @brief Protocolo del flujo de entrada
+ */
+enum FormatoTramas {
+    FORMATO_AUTO,       ///< Se decide por el primer byte (SYNC_BINARIO = binario)
+    FORMATO_TEXTO,      ///< Líneas "L,X", "M,N", "FIN"
+    FORMATO_BINARIO     ///< Tramas PRT-7B
+};
+
+/**
+ * @struct TramaBinaria
+ * @brief Trama binaria ya validada, como vista sobre el buffer de entrada
+ */
+struct TramaBinaria {
+    TipoTrama tipo;         ///< Tipo de trama
+    int rotacion;           ///< Posiciones a rotar (solo TRAMA_MAPEO)
+    const char* cargas;     ///< Caracteres (solo TRAMA_CARGA; uno solo si es racha)
+    int numCargas;          ///< Cargas que representa la trama
+    bool racha;             ///< true si son numCargas copias de cargas[0]
+};
+
+/**
+ * @brief Interpreta la trama que empieza en datos[0] (que debe ser SYNC_BINARIO)
+ * @param datos Bytes disponibles
+ * @param n Número de bytes disponibles
+ * @param trama Recibe la trama si es válida
+ * @return Bytes que ocupa la trama; 0 si faltan bytes; -1 si es inválida
+ *         (etiqueta desconocida, longitud 0, varint demasiado largo o crc)
+ */
+long decodificarTramaBinaria(const char* datos, size_t n, TramaBinaria& trama);
+
+/**
+ * @brief Escribe la línea de texto equivalente a una trama
+ * @param trama Trama de texto
+ * @param destino Buffer de al menos 16 bytes
+ * @return Bytes escritos ("L,X", "L,Space", "M,N" o "FIN"; sin terminador)
+ *
+ * Las tramas binarias se entregan a los ReceptorTramas con esta línea, así
+ * que los diagnósticos son los mismos que en el protocolo de texto.
+ */
+size_t escribirLineaTexto(const TramaParseada& trama, char* destino);
+
+/**
+ * @brief Recorre un buffer de tramas binarias en una sola pasada
+ * @param datos Inicio del buffer
+ * @param n Bytes en el buffer
+ * @param offsetBase Posición de datos[0] dentro del flujo (para los errores)
+ * @param receptor Destino de las tramas y errores encontrados
+ * @param esFinal true si no llegarán más bytes después del buffer
+ * @return Bytes consumidos. Si esFinal es false, una trama incompleta al
+ *         final no se consume y debe volver a pasarse con más datos.
+ *
+ * Equivalente binario de tokenizarTramas(): cada carga de un bloque se
+ * entrega como una trama TRAMA_CARGA. Los CR/LF entre tramas se ignoran;
+ * cualquier otro byte fuera de una trama, o una trama inválida, se reporta
+ * como ERROR_BINARIO_CORRUPTO y se sigue en el siguiente SYNC_BINARIO.
+ */
+size_t tokenizarTramasBinarias(const char* datos, size_t n, unsigned long long offsetBase,
+                               ReceptorTramas& receptor, bool esFinal);
+
+/**
+ * @class CodificadorBinario
+ * @brief Convierte tramas de texto en tramas PRT-7B
+ *
+ * Es un ReceptorTramas: se le pasa un flujo de texto con tokenizarTramas()
+ * y escribe el equivalente binario. Las cargas consecutivas se agrupan en
+ * bloques y las repeticiones de cuatro o más caracteres iguales se envían
+ * como rachas. Las líneas inválidas se descartan (ver getDescartadas()).
+ */
+class CodificadorBinario : public ReceptorTramas {
+    char* destino;                      ///< Buffer de salida
+    size_t usados;                      ///< Bytes escritos en 'destino'
+    char pendientes[MAX_CARGAS_BINARIAS]; ///< Cargas aún sin escribir
+    int numPendientes;                  ///< Cargas en 'pendientes'
+    unsigned long long descartadas;     ///< Líneas inválidas omitidas
+
+    /**
+     * @brief Escribe una trama completa (añade SYNC y crc)
+     */
+    void escribirTrama(unsigned char etiqueta, const unsigned char* contenido, size_t n);
+
+public:
+    /**
+     * @brief Constructor
+     * @param salida Buffer de al menos 2 * (bytes de texto) + MAX_TRAMA_BINARIA
+     */
+    explicit CodificadorBinario(char* salida);
+
+    void alRecibirTrama(const TramaParseada& trama, const char* linea,
+                        size_t longitud, unsigned long long offset);
+    void alErrorParseo(ErrorParseo error, const char* linea,
+                       size_t longitud, unsigned long long offset);
+
+    /**
+     * @brief Escribe las cargas pendientes (llamar al final del flujo)
+     */
+    void vaciar();
+
+    /**
+     * @brief Bytes escritos hasta ahora (llamar a vaciar() antes)
+     */
+    size_t getUsados() const { return usados; }
+
+    /**
+     * @brief Líneas inválidas que no se pudieron codificar
+     */
+    unsigned long long getDescartadas() const { return descartadas; }
+};
+
+/**
+ * @brief Convierte un flujo de texto completo a PRT-7B
+ * @param texto Líneas de texto
+ * @param n Bytes de texto
+ * @param destino Buffer de al menos 2 * n + MAX_TRAMA_BINARIA bytes
+ * @param descartadas Recibe las líneas inválidas omitidas (puede ser 0)
+ * @return Bytes escritos en destino
+ */
+size_t convertirABinario(const char* texto, size_t n, char* destino,
+                         unsigned long long* descartadas);
+
+#endif // PROTOCOLO_BINARIO_H
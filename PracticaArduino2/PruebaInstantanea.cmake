@@ -0,0 +1,107 @@
+# Pruebas de reanudación con --instantanea:
+#  - Captura cortada a media trama: la primera ejecución no debe decodificar
+#    "M,520" (parte de "M,5203") y la segunda, sobre la captura completa,
+#    debe producir el mismo mensaje que una ejecución sin cortes.
+#  - Palabra vigilada a caballo del corte con --ventana 0: el aviso debe
+#    darse igual que sin cortes.
+#
+# Uso: cmake -DDECODIFICADOR=<ejecutable> -DDIRECTORIO=<trabajo> -P PruebaInstantanea.cmake
+
+file(REMOVE_RECURSE "${DIRECTORIO}")
+file(MAKE_DIRECTORY "${DIRECTORIO}")
+
+# Captura determinista: cargas, rotaciones de varias cifras y algún FIN
+set(letras "HOLA MUNDO DESDE EL ARDUINO")
+string(LENGTH "${letras}" numLetras)
+set(inicio "")
+foreach(i RANGE 0 2999)
+    math(EXPR k "${i} % ${numLetras}")
+    string(SUBSTRING "${letras}" ${k} 1 c)
+    if(c STREQUAL " ")
+        string(APPEND inicio "L,Space\n")
+    else()
+        string(APPEND inicio "L,${c}\n")
+    endif()
+    math(EXPR m "${i} % 7")
+    if(m EQUAL 0)
+        math(EXPR r "${i} * 13 + 5")
+        string(APPEND inicio "M,${r}\n")
+    endif()
+    math(EXPR f "${i} % 1000")
+    if(f EQUAL 999)
+        string(APPEND inicio "FIN\n")
+    endif()
+endforeach()
+set(final "")
+foreach(i RANGE 0 499)
+    math(EXPR k "${i} % ${numLetras}")
+    string(SUBSTRING "${letras}" ${k} 1 c)
+    if(NOT c STREQUAL " ")
+        string(APPEND final "L,${c}\n")
+    endif()
+endforeach()
+
+file(WRITE "${DIRECTORIO}/completa.txt" "${inicio}M,5203\n${final}")
+file(WRITE "${DIRECTORIO}/parte.txt" "${inicio}M,520")
+
+# Ejecuta el decodificador y deja su stderr en 'avisos'
+function(ejecutar)
+    execute_process(COMMAND "${DECODIFICADOR}" ${ARGN}
+                    WORKING_DIRECTORY "${DIRECTORIO}"
+                    RESULT_VARIABLE resultado OUTPUT_QUIET ERROR_VARIABLE errores)
+    if(NOT resultado EQUAL 0)
+        message(FATAL_ERROR "Fallo (${resultado}): decodificador ${ARGN}\n${errores}")
+    endif()
+    set(avisos "${errores}" PARENT_SCOPE)
+endfunction()
+
+function(comparar referencia resultado)
+    execute_process(COMMAND "${CMAKE_COMMAND}" -E compare_files
+                            "${DIRECTORIO}/${referencia}" "${DIRECTORIO}/${resultado}"
+                    RESULT_VARIABLE distintos)
+    if(NOT distintos EQUAL 0)
+        message(FATAL_ERROR "${resultado} no coincide con ${referencia}")
+    endif()
+endfunction()
+
+# Referencia sin cortes
+ejecutar(--input completa.txt --modo silencioso --sumidero referencia.out)
+
+# Captura cortada y reanudación sobre la completa
+ejecutar(--input parte.txt --modo silencioso --sumidero reanudada.out --instantanea estado.inst)
+ejecutar(--input completa.txt --modo silencioso --sumidero reanudada.out --instantanea estado.inst)
+comparar(referencia.out reanudada.out)
+
+# Palabra vigilada: el corte cae tras "SEC" de "SECRETO" cuando el mensaje
+# acaba de superar ListaDeCarga::UMBRAL_VOLCADO, así que con --ventana 0 la
+# instantánea se toma justo después de un volcado al sumidero
+set(relleno "")
+foreach(i RANGE 1 19250)
+    math(EXPR k "${i} % ${numLetras}")
+    string(SUBSTRING "${letras}" ${k} 1 c)
+    if(NOT c STREQUAL " ")
+        string(APPEND relleno "L,${c}\n")
+    endif()
+endforeach()
+set(vigilada "${relleno}L,S\nL,E\nL,C\n")
+file(WRITE "${DIRECTORIO}/vigilada_parte.txt" "${vigilada}")
+file(WRITE "${DIRECTORIO}/vigilada.txt" "${vigilada}L,R\nL,E\nL,T\nL,O\n${final}FIN\n")
+
+set(opciones --modo silencioso --ventana 0 --vigilar SECRETO)
+ejecutar(--input vigilada.txt ${opciones} --sumidero vigilada_referencia.out)
+string(REGEX MATCHALL "Alerta[^\n]*" alertasReferencia "${avisos}")
+if(NOT alertasReferencia)
+    message(FATAL_ERROR "La ejecucion sin cortes no aviso de SECRETO")
+endif()
+
+ejecutar(--input vigilada_parte.txt ${opciones} --sumidero vigilada_reanudada.out
+         --instantanea vigilada.inst)
+string(REGEX MATCHALL "Alerta[^\n]*" alertas "${avisos}")
+ejecutar(--input vigilada.txt ${opciones} --sumidero vigilada_reanudada.out
+         --instantanea vigilada.inst)
+string(REGEX MATCHALL "Alerta[^\n]*" alertasReanudada "${avisos}")
+list(APPEND alertas ${alertasReanudada})
+if(NOT alertas STREQUAL alertasReferencia)
+    message(FATAL_ERROR "Avisos distintos al reanudar: '${alertas}' frente a '${alertasReferencia}'")
+endif()
+comparar(vigilada_referencia.out vigilada_reanudada.out)
@@ -0,0 +1,98 @@
+# Pruebas de coherencia entre los modos de entrada: el mensaje que deja
+# --sumidero debe ser el mismo con --input que leyendo la captura como
+# puerto (en un hilo, repartida en etapas o junto a otro puerto) y que
+# repartiendo la captura con --hilos.
+#
+# Uso: cmake -DDECODIFICADOR=<ejecutable> -DFUENTES=<pruebas> -DDIRECTORIO=<trabajo>
+#            -P PruebaModos.cmake
+
+file(REMOVE_RECURSE "${DIRECTORIO}")
+file(MAKE_DIRECTORY "${DIRECTORIO}")
+
+# Ejecuta el decodificador y deja su stderr en 'avisos'
+function(ejecutar)
+    execute_process(COMMAND "${DECODIFICADOR}" ${ARGN}
+                    WORKING_DIRECTORY "${DIRECTORIO}"
+                    RESULT_VARIABLE resultado OUTPUT_QUIET ERROR_VARIABLE errores)
+    if(NOT resultado EQUAL 0)
+        message(FATAL_ERROR "Fallo (${resultado}): decodificador ${ARGN}\n${errores}")
+    endif()
+    set(avisos "${errores}" PARENT_SCOPE)
+endfunction()
+
+# Mensaje de un sumidero sin la cabecera "==> RUTA <==" de cada mensaje
+function(leerMensaje archivo variable)
+    file(READ "${DIRECTORIO}/${archivo}" contenido)
+    string(REGEX REPLACE "==> [^\n]* <==\n" "" contenido "${contenido}")
+    set(${variable} "${contenido}" PARENT_SCOPE)
+endfunction()
+
+function(exigirIgual captura modo obtenido esperado)
+    if(NOT obtenido STREQUAL esperado)
+        message(FATAL_ERROR "${captura}: ${modo} da '${obtenido}' y --input da '${esperado}'")
+    endif()
+endfunction()
+
+# Decodifica 'captura' con --input y con cada modo de puerto, y compara.
+# Los argumentos extra se añaden a la ejecución con --hilos; sin ellos la
+# captura no se prueba con --hilos (p. ej. las binarias, que van en un hilo)
+function(compararModos captura)
+    ejecutar(--input ${captura} --modo silencioso --sumidero ${captura}.input.out)
+    leerMensaje(${captura}.input.out esperado)
+    if(esperado STREQUAL "")
+        message(FATAL_ERROR "${captura}: --input no produjo ningun mensaje")
+    endif()
+
+    foreach(etapas 1 2 3)
+        ejecutar(--puerto ${captura} --etapas ${etapas} --modo silencioso
+                 --sumidero ${captura}.etapas${etapas}.out)
+        leerMensaje(${captura}.etapas${etapas}.out obtenido)
+        exigirIgual(${captura} "--puerto --etapas ${etapas}" "${obtenido}" "${esperado}")
+    endforeach()
+
+    # Dos puertos a la vez: cada uno deja su mensaje en RUTA.0 y RUTA.1
+    ejecutar(--puerto ${captura} --puerto ${captura} --modo silencioso
+             --sumidero ${captura}.puertos.out)
+    foreach(indice 0 1)
+        leerMensaje(${captura}.puertos.out.${indice} obtenido)
+        exigirIgual(${captura} "el puerto ${indice} de dos" "${obtenido}" "${esperado}")
+    endforeach()
+
+    if(ARGN)
+        ejecutar(--input ${captura} ${ARGN} --sumidero ${captura}.hilos.out)
+        leerMensaje(${captura}.hilos.out obtenido)
+        exigirIgual(${captura} "--input ${ARGN}" "${obtenido}" "${esperado}")
+    endif()
+endfunction()
+
+# Última trama sin salto de línea: también debe decodificarse
+file(WRITE "${DIRECTORIO}/sin_salto_final.txt" "L,H\r\nL,O\r\nM,2\r\nL,J")
+compararModos(sin_salto_final.txt --hilos 2)
+leerMensaje(sin_salto_final.txt.input.out mensaje)
+if(NOT mensaje STREQUAL "HOL\n")
+    message(FATAL_ERROR "sin_salto_final.txt: se esperaba 'HOL' y se obtuvo '${mensaje}'")
+endif()
+
+# Capturas de pruebas/: la de texto (con CRLF, líneas vacías y sin FIN al
+# final) y su versión PRT-7B
+foreach(captura mensajes.txt mensajes.bin)
+    file(COPY "${FUENTES}/${captura}" DESTINATION "${DIRECTORIO}")
+endforeach()
+compararModos(mensajes.txt)
+compararModos(mensajes.bin)
+
+# --hilos solo reparte capturas de al menos DecodificadorParalelo::TRAMO_MINIMO
+# (1 MB) por hilo: se duplica mensajes.txt hasta pasar de 4 MB para que
+# los tramos corten mensajes y rachas de MAP
+file(READ "${DIRECTORIO}/mensajes.txt" grande)
+string(LENGTH "${grande}" longitud)
+while(longitud LESS 4194304)
+    string(APPEND grande "${grande}")
+    string(LENGTH "${grande}" longitud)
+endwhile()
+file(WRITE "${DIRECTORIO}/grande.txt" "${grande}")
+compararModos(grande.txt --hilos 4)
+ejecutar(--input grande.txt --hilos 0 --sumidero grande.txt.todos.out)
+leerMensaje(grande.txt.input.out esperado)
+leerMensaje(grande.txt.todos.out obtenido)
+exigirIgual(grande.txt "--input --hilos 0" "${obtenido}" "${esperado}")
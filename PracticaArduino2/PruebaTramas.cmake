@@ -0,0 +1,76 @@
+# Pruebas de decodificación sobre las capturas de pruebas/, comparadas con
+# los resultados guardados junto a ellas (*.esperado):
+#  - errores.txt: cada trama inválida se informa con su texto y su offset
+#    y las válidas que la rodean siguen decodificándose.
+#  - mensajes.txt: rotaciones encadenadas (negativas, grandes y extremos
+#    de int) dan el mismo mensaje con y sin plegado de MAP.
+#  - mensajes.bin: la misma captura en PRT-7B da el mismo mensaje.
+#  - crc_erroneo.bin: una trama con el CRC roto se descarta y se informa.
+#
+# Uso: cmake -DDECODIFICADOR=<ejecutable> -DFUENTES=<pruebas> -DDIRECTORIO=<trabajo>
+#            -P PruebaTramas.cmake
+
+file(REMOVE_RECURSE "${DIRECTORIO}")
+file(MAKE_DIRECTORY "${DIRECTORIO}")
+
+# Ejecuta el decodificador y deja su stderr en 'avisos'
+function(ejecutar)
+    execute_process(COMMAND "${DECODIFICADOR}" ${ARGN}
+                    WORKING_DIRECTORY "${FUENTES}"
+                    RESULT_VARIABLE resultado OUTPUT_QUIET ERROR_VARIABLE errores)
+    if(NOT resultado EQUAL 0)
+        message(FATAL_ERROR "Fallo (${resultado}): decodificador ${ARGN}\n${errores}")
+    endif()
+    set(avisos "${errores}" PARENT_SCOPE)
+endfunction()
+
+# Compara el mensaje de un sumidero (sin cabeceras "==> RUTA <==") con un
+# archivo *.esperado
+function(compararMensaje sumidero esperado)
+    file(READ "${DIRECTORIO}/${sumidero}" obtenido)
+    string(REGEX REPLACE "==> [^\n]* <==\n" "" obtenido "${obtenido}")
+    file(READ "${FUENTES}/${esperado}" referencia)
+    if(NOT obtenido STREQUAL referencia)
+        message(FATAL_ERROR "${sumidero}: se esperaba\n${referencia}y se obtuvo\n${obtenido}")
+    endif()
+endfunction()
+
+# Compara las líneas "Error: ..." de la última ejecución con un *.esperado
+function(compararErrores captura esperado)
+    string(REGEX MATCHALL "Error: [^\n]*\n" lineas "${avisos}")
+    string(REPLACE ";" "" obtenido "${lineas}")
+    file(READ "${FUENTES}/${esperado}" referencia)
+    if(NOT obtenido STREQUAL referencia)
+        message(FATAL_ERROR "${captura}: se esperaban los errores\n${referencia}"
+                            "y se obtuvieron\n${obtenido}")
+    endif()
+endfunction()
+
+# Errores del parser con su offset
+ejecutar(--input errores.txt --modo silencioso --sumidero "${DIRECTORIO}/errores.out")
+compararErrores(errores.txt errores.esperado)
+file(READ "${DIRECTORIO}/errores.out" mensaje)
+if(NOT mensaje MATCHES "HOL\n$")
+    message(FATAL_ERROR "errores.txt: las tramas validas no dieron 'HOL': '${mensaje}'")
+endif()
+
+# Plegado de MAP: silencioso pliega las rachas, fragmento y completo no
+foreach(modo silencioso fragmento completo)
+    ejecutar(--input mensajes.txt --modo ${modo} --sumidero "${DIRECTORIO}/mensajes.${modo}.out")
+    compararMensaje(mensajes.${modo}.out mensajes.esperado)
+endforeach()
+
+# PRT-7B: ida y vuelta y CRC roto
+ejecutar(--input mensajes.bin --modo silencioso --sumidero "${DIRECTORIO}/mensajes.bin.out")
+compararMensaje(mensajes.bin.out mensajes.esperado)
+if(avisos MATCHES "Error:")
+    message(FATAL_ERROR "mensajes.bin: errores inesperados\n${avisos}")
+endif()
+
+ejecutar(--input crc_erroneo.bin --modo silencioso --sumidero "${DIRECTORIO}/crc_erroneo.out")
+compararErrores(crc_erroneo.bin crc_erroneo.esperado)
+file(READ "${DIRECTORIO}/crc_erroneo.out" mensaje)
+string(REGEX REPLACE "==> [^\n]* <==\n" "" mensaje "${mensaje}")
+if(NOT mensaje STREQUAL "\nFOMBDFOLQLOXIFPQLWW\nMOQXPFBQB\n")
+    message(FATAL_ERROR "crc_erroneo.bin: solo debia perderse la primera carga: '${mensaje}'")
+endif()
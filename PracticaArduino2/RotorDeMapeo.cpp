@@ -4,23 +4,218 @@
  */
 
 #include "RotorDeMapeo.h"
+#include "Alfabetos.h"
+#include <cstring>
 #include <iostream>
 
-RotorDeMapeo::RotorDeMapeo() : cabeza(0), tamanio(0) {
-    // Alfabeto A-Z + espacio (27 caracteres)
-    const char alfabeto[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ ";
-    int longitud = 27;
+// Los kernels vectoriales solo existen en x86; AVX2 requiere GCC/Clang
+// para compilarlo por función y elegirlo en tiempo de ejecución.
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+    #define ROTOR_SSE2 1
+    #include <emmintrin.h>
+    #if defined(__GNUC__)
+        #define ROTOR_AVX2 1
+        #include <immintrin.h>
+    #endif
+#endif
+
+namespace {
+
+/**
+ * @brief Firma común de los kernels de mapearBloque
+ * 
+ * Procesan el mayor prefijo múltiplo de su ancho de vector y devuelven
+ * cuántos bytes tradujeron; el resto lo completa la tabla escalar.
+ */
+typedef size_t (*KernelBloque)(const char*, char*, size_t, const ParametrosBloque&, int);
+
+#ifdef ROTOR_SSE2
+size_t mapearSse2(const char* entrada, char* salida, size_t n,
+                  const ParametrosBloque& p, int desplazamiento) {
+    const int total = p.longitud + (p.conExtra ? 1 : 0);
+    const __m128i base = _mm_set1_epi8((char)p.base);
+    const __m128i limite = _mm_set1_epi8((char)(p.longitud - 1));
+    const __m128i longitud = _mm_set1_epi8((char)p.longitud);
+    const __m128i modulo = _mm_set1_epi8((char)total);
+    const __m128i extra = _mm_set1_epi8((char)p.extra);
+    const __m128i conExtra = _mm_set1_epi8(p.conExtra ? (char)0xFF : 0);
+    const __m128i despl = _mm_set1_epi8((char)desplazamiento);
+    
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(entrada + i));
+        
+        // Índice dentro del alfabeto: rango contiguo o símbolo extra
+        __m128i idx = _mm_sub_epi8(x, base);
+        __m128i enRango = _mm_cmpeq_epi8(_mm_min_epu8(idx, limite), idx);
+        __m128i esExtra = _mm_and_si128(_mm_cmpeq_epi8(x, extra), conExtra);
+        __m128i indice = _mm_or_si128(_mm_and_si128(enRango, idx),
+                                      _mm_and_si128(esExtra, longitud));
+        
+        // (indice + desplazamiento) mod total, sin división
+        __m128i j = _mm_add_epi8(indice, despl);
+        j = _mm_min_epu8(j, _mm_sub_epi8(j, modulo));
+        
+        // Volver a símbolo y dejar intactos los bytes fuera del alfabeto
+        __m128i salidaExtra = _mm_and_si128(_mm_cmpeq_epi8(j, longitud), conExtra);
+        __m128i simbolo = _mm_or_si128(_mm_and_si128(salidaExtra, extra),
+                                       _mm_andnot_si128(salidaExtra, _mm_add_epi8(j, base)));
+        __m128i valido = _mm_or_si128(enRango, esExtra);
+        __m128i r = _mm_or_si128(_mm_and_si128(valido, simbolo),
+                                 _mm_andnot_si128(valido, x));
+        _mm_storeu_si128((__m128i*)(salida + i), r);
+    }
+    return i;
+}
+#endif
+
+#ifdef ROTOR_AVX2
+__attribute__((target("avx2")))
+size_t mapearAvx2(const char* entrada, char* salida, size_t n,
+                  const ParametrosBloque& p, int desplazamiento) {
+    const int total = p.longitud + (p.conExtra ? 1 : 0);
+    const __m256i base = _mm256_set1_epi8((char)p.base);
+    const __m256i limite = _mm256_set1_epi8((char)(p.longitud - 1));
+    const __m256i longitud = _mm256_set1_epi8((char)p.longitud);
+    const __m256i modulo = _mm256_set1_epi8((char)total);
+    const __m256i extra = _mm256_set1_epi8((char)p.extra);
+    const __m256i conExtra = _mm256_set1_epi8(p.conExtra ? (char)0xFF : 0);
+    const __m256i despl = _mm256_set1_epi8((char)desplazamiento);
+    
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(entrada + i));
+        
+        __m256i idx = _mm256_sub_epi8(x, base);
+        __m256i enRango = _mm256_cmpeq_epi8(_mm256_min_epu8(idx, limite), idx);
+        __m256i esExtra = _mm256_and_si256(_mm256_cmpeq_epi8(x, extra), conExtra);
+        __m256i indice = _mm256_or_si256(_mm256_and_si256(enRango, idx),
+                                         _mm256_and_si256(esExtra, longitud));
+        
+        __m256i j = _mm256_add_epi8(indice, despl);
+        j = _mm256_min_epu8(j, _mm256_sub_epi8(j, modulo));
+        
+        __m256i salidaExtra = _mm256_and_si256(_mm256_cmpeq_epi8(j, longitud), conExtra);
+        __m256i simbolo = _mm256_blendv_epi8(_mm256_add_epi8(j, base), extra, salidaExtra);
+        __m256i valido = _mm256_or_si256(enRango, esExtra);
+        _mm256_storeu_si256((__m256i*)(salida + i), _mm256_blendv_epi8(x, simbolo, valido));
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief Elige el kernel más ancho que soporta la CPU actual
+ * @return Kernel vectorial, o 0 si solo está disponible la tabla escalar
+ */
+KernelBloque elegirKernel() {
+#if defined(ROTOR_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return mapearAvx2;
+#endif
+#if defined(ROTOR_SSE2)
+    return mapearSse2;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Indica si los símbolos son exactamente los del alfabeto A
+ */
+template <class A>
+bool esAlfabeto(const char* simbolos, int longitud) {
+    return longitud == A::TAMANIO &&
+           std::memcmp(simbolos, TablaSimbolos<A>::valores, (size_t)longitud) == 0;
+}
+
+/**
+ * @brief Kernel de RotorFijo para un alfabeto conocido
+ * @return RotorFijo<A>::mapearCon, o 0 si el alfabeto no es uno de Alfabetos.h
+ */
+void (*elegirKernelFijo(const char* simbolos, int longitud))(const char*, char*, size_t, int) {
+    if (esAlfabeto<AlfabetoPrt7>(simbolos, longitud)) return RotorFijo<AlfabetoPrt7>::mapearCon;
+    if (esAlfabeto<AlfabetoDigitos>(simbolos, longitud)) return RotorFijo<AlfabetoDigitos>::mapearCon;
+    if (esAlfabeto<AlfabetoMinusculas>(simbolos, longitud)) return RotorFijo<AlfabetoMinusculas>::mapearCon;
+    if (esAlfabeto<AlfabetoBytes>(simbolos, longitud)) return RotorFijo<AlfabetoBytes>::mapearCon;
+    return 0;
+}
+
+} // namespace
+
+RotorDeMapeo::RotorDeMapeo()
+    : cabeza(0), origen(0), tamanio(0), desplazamiento(0),
+      cabezaPendiente(false), tablas(0), tabla(0), alfabeto(0), kernelFijo(0) {
+    construirAnillo(0, 0);
+}
+
+RotorDeMapeo::RotorDeMapeo(const char* simbolos, int longitud)
+    : cabeza(0), origen(0), tamanio(0), desplazamiento(0),
+      cabezaPendiente(false), tablas(0), tabla(0), alfabeto(0), kernelFijo(0) {
+    construirAnillo(simbolos, longitud);
+}
+
+bool RotorDeMapeo::esAlfabetoValido(const char* simbolos, int longitud) {
+    if (!simbolos || longitud < 2 || longitud > 256) return false;
+    
+    // Sin repetidos, o la tabla no sería biyectiva
+    bool vistos[256] = { false };
+    for (int i = 0; i < longitud; i++) {
+        unsigned char c = (unsigned char)simbolos[i];
+        if (vistos[c]) return false;
+        vistos[c] = true;
+    }
+    return true;
+}
+
+bool RotorDeMapeo::buscarAlfabeto(const char* nombre, const char*& simbolos, int& longitud) {
+    if (std::strcmp(nombre, "prt7") == 0) {
+        simbolos = TablaSimbolos<AlfabetoPrt7>::valores;
+        longitud = AlfabetoPrt7::TAMANIO;
+    } else if (std::strcmp(nombre, "digitos") == 0) {
+        simbolos = TablaSimbolos<AlfabetoDigitos>::valores;
+        longitud = AlfabetoDigitos::TAMANIO;
+    } else if (std::strcmp(nombre, "minusculas") == 0) {
+        simbolos = TablaSimbolos<AlfabetoMinusculas>::valores;
+        longitud = AlfabetoMinusculas::TAMANIO;
+    } else if (std::strcmp(nombre, "bytes") == 0) {
+        simbolos = TablaSimbolos<AlfabetoBytes>::valores;
+        longitud = AlfabetoBytes::TAMANIO;
+    } else {
+        // Símbolos literales (sin el byte 0, que termina la cadena)
+        size_t n = std::strlen(nombre);
+        if (n > 255 || !esAlfabetoValido(nombre, (int)n)) return false;
+        simbolos = nombre;
+        longitud = (int)n;
+    }
+    return true;
+}
+
+void RotorDeMapeo::construirAnillo(const char* simbolos, int longitud) {
+    if (simbolos && !esAlfabetoValido(simbolos, longitud)) {
+        // Sin al menos dos símbolos distintos no hay tablas ni módulo válidos
+        std::cerr << "Error: Alfabeto de rotor invalido (" << longitud
+                  << " simbolos o repetidos); se usa A-Z y espacio" << std::endl;
+        simbolos = 0;
+    }
+    if (!simbolos) {
+        // Alfabeto A-Z + espacio (27 caracteres)
+        simbolos = TablaSimbolos<AlfabetoPrt7>::valores;
+        longitud = AlfabetoPrt7::TAMANIO;
+    }
+    alfabeto = simbolos;
     
     NodoRotor* anterior = 0;
     NodoRotor* primero = 0;
     
     // Crear la lista circular
     for (int i = 0; i < longitud; i++) {
-        NodoRotor* nuevo = new NodoRotor(alfabeto[i]);
+        NodoRotor* nuevo = new NodoRotor(simbolos[i]);
         
         if (i == 0) {
             primero = nuevo;
             cabeza = nuevo;  // Inicialmente, cabeza apunta a 'A'
+            origen = nuevo;
         } else {
             anterior->siguiente = nuevo;
             nuevo->previo = anterior;
@@ -35,17 +230,23 @@ RotorDeMapeo::RotorDeMapeo() : cabeza(0), tamanio(0) {
         anterior->siguiente = primero;
         primero->previo = anterior;
     }
+    
+    construirTablas();
+    analizarAlfabeto();
+    kernelFijo = elegirKernelFijo(simbolos, longitud);
 }
 
 RotorDeMapeo::~RotorDeMapeo() {
-    if (!cabeza) return;
+    delete[] tablas;
+    
+    if (!origen) return;
     
     // Romper el círculo para evitar bucle infinito
-    NodoRotor* ultimo = cabeza->previo;
+    NodoRotor* ultimo = origen->previo;
     ultimo->siguiente = 0;
     
     // Eliminar todos los nodos
-    NodoRotor* actual = cabeza;
+    NodoRotor* actual = origen;
     while (actual) {
         NodoRotor* siguiente = actual->siguiente;
         delete actual;
@@ -54,98 +255,132 @@ RotorDeMapeo::~RotorDeMapeo() {
 }
 
 void RotorDeMapeo::rotar(int n) {
-    if (!cabeza) return;
+    if (!origen) return;
     
-    // Normalizar n al rango [-tamanio, tamanio]
+    // Normalizar n al rango [-tamanio, tamanio] y luego a [0, tamanio)
     int pasos = n % tamanio;
+    desplazamiento = (desplazamiento + pasos + tamanio) % tamanio;
     
-    // Rotar hacia la derecha (positivo)
-    if (pasos > 0) {
-        for (int i = 0; i < pasos; i++) {
-            cabeza = cabeza->siguiente;
+    tabla = tablas + desplazamiento * 256;
+    cabezaPendiente = true;
+}
+
+void RotorDeMapeo::reiniciar() {
+    if (!origen) return;
+    
+    desplazamiento = 0;
+    tabla = tablas;
+    cabezaPendiente = true;
+}
+
+void RotorDeMapeo::construirTablas() {
+    tablas = new char[tamanio * 256];
+    
+    NodoRotor* inicio = origen;
+    for (int d = 0; d < tamanio; d++) {
+        char* actualTabla = tablas + d * 256;
+        
+        // Los bytes que no están en el alfabeto pasan sin cambios
+        for (int i = 0; i < 256; i++) {
+            actualTabla[i] = (char)i;
         }
-    }
-    // Rotar hacia la izquierda (negativo)
-    else if (pasos < 0) {
-        for (int i = 0; i > pasos; i--) {
-            cabeza = cabeza->previo;
+        
+        // El símbolo a distancia i de 'A' se mapea al símbolo a distancia i de cabeza
+        NodoRotor* entrada = origen;
+        NodoRotor* salida = inicio;
+        for (int i = 0; i < tamanio; i++) {
+            actualTabla[(unsigned char)entrada->dato] = salida->dato;
+            entrada = entrada->siguiente;
+            salida = salida->siguiente;
         }
+        
+        inicio = inicio->siguiente;
     }
+    
+    tabla = tablas + desplazamiento * 256;
 }
 
-char RotorDeMapeo::getMapeo(char entrada) {
-    if (!cabeza) return entrada;
+void RotorDeMapeo::analizarAlfabeto() {
+    forma.base = 0;
+    forma.longitud = 0;
+    forma.extra = 0;
+    forma.conExtra = false;
+    forma.vectorizable = false;
     
-    // Buscar el carácter de entrada en el rotor
-    NodoRotor* actual = cabeza;
-    int posicion = 0;
-    bool encontrado = false;
+    // Los kernels trabajan con bytes sin signo y necesitan 2*tamanio < 256
+    if (!origen || tamanio < 2 || tamanio > 127) return;
     
-    for (int i = 0; i < tamanio; i++) {
-        if (actual->dato == entrada) {
-            encontrado = true;
-            posicion = i;
-            break;
-        }
+    // Medir el rango contiguo inicial
+    NodoRotor* actual = origen;
+    int longitud = 1;
+    while (longitud < tamanio &&
+           (unsigned char)actual->siguiente->dato == (unsigned char)actual->dato + 1) {
         actual = actual->siguiente;
+        longitud++;
     }
     
-    // Si no se encuentra, devolver sin mapear
-    if (!encontrado) return entrada;
-    
-    // El mapeo: el carácter en la posición 'posicion' desde cabeza
-    // se mapea al carácter que está en esa misma posición desde el inicio original
-    // 
-    // LÓGICA SIMPLIFICADA: 
-    // Si el rotor no ha rotado, cada letra se mapea a sí misma.
-    // Si rotó +2, entonces 'A' (que ahora está 2 posiciones antes de cabeza)
-    // se mapea a lo que cabeza apunta (ej. 'C').
-    //
-    // Para implementar esto correctamente:
-    // 1. Encontramos dónde está el carácter de entrada (ya hecho)
-    // 2. Devolvemos el carácter que está en la posición cero (cabeza)
-    //    ajustado por la posición encontrada
-    
-    // Forma directa: el desplazamiento es cuánto se movió la cabeza
-    // Si cabeza apunta a 'C' (rotación +2), entonces:
-    // - 'A' está 2 posiciones antes de 'C', se mapea a 'A' + 2 = 'C'
-    // - 'B' está 2 posiciones antes de 'D', se mapea a 'B' + 2 = 'D'
-    
-    // Encontrar el carácter base (el que estaba originalmente en posición 0)
-    NodoRotor* baseOriginal = cabeza;
-    for (int i = 0; i < tamanio; i++) {
-        if (baseOriginal->dato == 'A') {
-            break;
-        }
-        baseOriginal = baseOriginal->siguiente;
+    // Se admite como mucho un símbolo extra fuera del rango
+    unsigned char base = (unsigned char)origen->dato;
+    if (longitud == tamanio) {
+        forma.conExtra = false;
+    } else if (longitud == tamanio - 1) {
+        unsigned char extra = (unsigned char)actual->siguiente->dato;
+        if (extra >= base && extra < base + longitud) return;
+        forma.extra = extra;
+        forma.conExtra = true;
+    } else {
+        return;
     }
     
-    // Calcular cuántas posiciones está 'entrada' desde baseOriginal
-    actual = baseOriginal;
-    int distancia = 0;
-    for (int i = 0; i < tamanio; i++) {
-        if (actual->dato == entrada) {
-            distancia = i;
-            break;
-        }
-        actual = actual->siguiente;
+    forma.base = base;
+    forma.longitud = (unsigned char)longitud;
+    forma.vectorizable = true;
+}
+
+void RotorDeMapeo::mapearBloque(const char* entrada, char* salida, size_t n) const {
+    static const KernelBloque kernel = elegirKernel();
+    
+    size_t i = 0;
+    if (kernel && forma.vectorizable) {
+        i = kernel(entrada, salida, n, forma, desplazamiento);
+    } else if (kernelFijo) {
+        // Alfabeto conocido al compilar: suma y ajuste con módulo constante
+        kernelFijo(entrada, salida, n, desplazamiento);
+        return;
+    }
+    
+    // Cola (o todo el bloque) con la tabla escalar
+    for (; i < n; i++) {
+        salida[i] = tabla[(unsigned char)entrada[i]];
     }
+}
+
+void RotorDeMapeo::sincronizarCabeza() {
+    if (!cabezaPendiente) return;
     
-    // El resultado es el carácter en cabeza avanzado 'distancia' posiciones
-    NodoRotor* resultado = cabeza;
-    for (int i = 0; i < distancia; i++) {
-        resultado = resultado->siguiente;
+    // Avanzar por el camino más corto desde 'A'
+    cabeza = origen;
+    if (desplazamiento <= tamanio / 2) {
+        for (int i = 0; i < desplazamiento; i++) {
+            cabeza = cabeza->siguiente;
+        }
+    } else {
+        for (int i = desplazamiento; i < tamanio; i++) {
+            cabeza = cabeza->previo;
+        }
     }
     
-    return resultado->dato;
+    cabezaPendiente = false;
 }
 
 void RotorDeMapeo::mostrarRotor() {
-    if (!cabeza) {
+    if (!origen) {
         std::cout << "Rotor vacio" << std::endl;
         return;
     }
     
+    sincronizarCabeza();
+    
     std::cout << "Rotor (cabeza en '" << cabeza->dato << "'): ";
     NodoRotor* actual = cabeza;
     for (int i = 0; i < tamanio; i++) {
@@ -8,6 +8,8 @@
 #ifndef ROTOR_DE_MAPEO_H
 #define ROTOR_DE_MAPEO_H
 
+#include <cstddef>
+
 /**
  * @struct NodoRotor
  * @brief Nodo individual de la lista circular que contiene un carácter
@@ -24,20 +26,85 @@ struct NodoRotor {
     NodoRotor(char c) : dato(c), siguiente(0), previo(0) {}
 };
 
+/**
+ * @struct ParametrosBloque
+ * @brief Forma del alfabeto usada por los kernels vectoriales de mapearBloque
+ * 
+ * Los kernels SIMD no consultan la tabla: tratan el alfabeto como un rango
+ * contiguo de bytes [base, base + longitud) seguido opcionalmente de un
+ * símbolo extra (el espacio en PRT-7), y traducen con suma y ajuste modular.
+ */
+struct ParametrosBloque {
+    unsigned char base;       ///< Primer byte del rango contiguo ('A')
+    unsigned char longitud;   ///< Símbolos en el rango contiguo (26)
+    unsigned char extra;      ///< Símbolo adicional al final del alfabeto (' ')
+    bool conExtra;            ///< true si el alfabeto tiene símbolo extra
+    bool vectorizable;        ///< false si el alfabeto no tiene esta forma
+};
+
 /**
  * @class RotorDeMapeo
  * @brief Lista circular doblemente enlazada que simula un disco de cifrado
  * 
- * Funciona como una "Rueda de César" dinámica. Contiene el alfabeto A-Z más
- * el espacio, y puede rotar para cambiar el mapeo de caracteres.
+ * Funciona como una "Rueda de César" dinámica. Por defecto contiene el
+ * alfabeto A-Z más el espacio, y puede rotar para cambiar el mapeo de
+ * caracteres.
  * 
  * Ejemplo: Si cabeza apunta a 'A' y rotamos +2, cabeza apuntará a 'C'.
  * Entonces 'A' se mapeará a 'C', 'B' a 'D', etc.
+ * 
+ * El alfabeto se elige al construir. getMapeo() siempre consulta las
+ * tablas construidas aquí. mapearBloque() prefiere los kernels vectoriales
+ * cuando el alfabeto tiene su forma, como prt7, digitos y minusculas en
+ * x86. El RotorFijo de Alfabetos.h solo se usa para un alfabeto conocido
+ * sin kernel: "bytes", o cualquiera de ellos fuera de x86. El resto de
+ * alfabetos usa la tabla escalar.
  */
 class RotorDeMapeo {
 private:
-    NodoRotor* cabeza;      ///< Posición "cero" actual del rotor
+    NodoRotor* cabeza;      ///< Posición "cero" actual del rotor (se materializa bajo demanda)
+    NodoRotor* origen;      ///< Nodo del primer símbolo del alfabeto ('A')
     int tamanio;            ///< Número total de caracteres en el rotor
+    int desplazamiento;     ///< Posiciones que cabeza está adelantada respecto a origen
+    bool cabezaPendiente;   ///< true si 'cabeza' no refleja aún el desplazamiento
+    char* tablas;           ///< Una tabla de traducción de 256 entradas por cada desplazamiento
+    const char* tabla;      ///< Tabla del desplazamiento actual (apunta dentro de 'tablas')
+    ParametrosBloque forma; ///< Forma del alfabeto para los kernels de mapearBloque
+    const char* alfabeto;   ///< Símbolos con los que se construyó (no se copian)
+    /// RotorFijo::mapearCon() del alfabeto, o 0 si no es uno conocido
+    void (*kernelFijo)(const char*, char*, size_t, int);
+    
+    /**
+     * @brief Crea la lista circular, sus tablas y elige los kernels
+     * @param simbolos Símbolos del alfabeto (0 = A-Z y espacio)
+     * @param longitud Número de símbolos
+     */
+    void construirAnillo(const char* simbolos, int longitud);
+    
+    /**
+     * @brief Precalcula las tablas de traducción a partir de la lista circular
+     * 
+     * Para cada desplazamiento d recorre el rotor en paralelo desde 'origen'
+     * y desde el nodo a distancia d, de modo que tablas[d][x] queda igual a
+     * lo que devolvería la búsqueda lineal original. Los bytes fuera del
+     * alfabeto se mapean a sí mismos.
+     */
+    void construirTablas();
+    
+    /**
+     * @brief Determina si el alfabeto admite los kernels vectoriales
+     * 
+     * Llena 'forma' recorriendo el anillo desde 'origen'.
+     */
+    void analizarAlfabeto();
+    
+    /**
+     * @brief Mueve 'cabeza' al nodo indicado por 'desplazamiento'
+     * 
+     * Solo se invoca cuando alguien necesita recorrer el anillo; rotar()
+     * únicamente actualiza el desplazamiento.
+     */
+    void sincronizarCabeza();
     
 public:
     /**
@@ -45,6 +112,18 @@ public:
      */
     RotorDeMapeo();
     
+    /**
+     * @brief Constructor con un alfabeto propio
+     * @param simbolos Símbolos en orden, sin repetidos; deben seguir vivos
+     *        mientras exista el rotor. 0 = A-Z y espacio
+     * @param longitud Número de símbolos (2-256)
+     * 
+     * Un alfabeto inválido (menos de 2 o más de 256 símbolos, o con
+     * repetidos) se rechaza con un mensaje en std::cerr y el rotor queda
+     * con A-Z y espacio.
+     */
+    RotorDeMapeo(const char* simbolos, int longitud);
+    
     /**
      * @brief Destructor que libera toda la memoria de los nodos
      */
@@ -54,10 +133,17 @@ public:
      * @brief Rota el rotor N posiciones
      * @param n Número de posiciones a rotar (positivo=derecha, negativo=izquierda)
      * 
-     * No mueve los datos, solo cambia el puntero 'cabeza' de forma circular.
+     * No mueve los datos ni recorre nodos: actualiza el desplazamiento con
+     * aritmética modular y selecciona la tabla correspondiente. El puntero
+     * 'cabeza' se recoloca después, solo si alguien recorre el anillo.
      */
     void rotar(int n);
     
+    /**
+     * @brief Vuelve el rotor a su posición inicial ('A' -> 'A')
+     */
+    void reiniciar();
+    
     /**
      * @brief Obtiene el carácter mapeado según la rotación actual
      * @param entrada Carácter a mapear
@@ -66,11 +152,67 @@ public:
      * Lógica: Encuentra 'entrada' en el rotor, calcula su distancia desde
      * 'cabeza', y devuelve el carácter que está a esa misma distancia
      * desde la posición cero original.
+     * 
+     * La búsqueda ya está resuelta en la tabla precalculada del
+     * desplazamiento actual, así que cada consulta es un único acceso indexado.
      */
-    char getMapeo(char entrada);
+    char getMapeo(char entrada) const { return tabla[(unsigned char)entrada]; }
+    
+    /**
+     * @brief Mapea un bloque completo de caracteres con la rotación actual
+     * @param entrada Caracteres a mapear
+     * @param salida Buffer donde se escriben los caracteres mapeados (puede ser 'entrada')
+     * @param n Número de caracteres
+     * 
+     * Equivale a llamar getMapeo() sobre cada carácter, pero en una sola
+     * pasada. En x86 usa un kernel AVX2 o SSE2 elegido en tiempo de ejecución
+     * según la CPU; en otras plataformas, o si el alfabeto no tiene la forma
+     * esperada, recurre a la tabla escalar.
+     */
+    void mapearBloque(const char* entrada, char* salida, size_t n) const;
+    
+    /**
+     * @brief Obtiene la rotación neta actual
+     * @return Desplazamiento de cabeza respecto a 'A', en [0, tamanio)
+     */
+    int getDesplazamiento() const { return desplazamiento; }
+    
+    /**
+     * @brief Obtiene el número de símbolos del rotor
+     * @return Tamaño del alfabeto (módulo de las rotaciones)
+     */
+    int getTamanio() const { return tamanio; }
+    
+    /**
+     * @brief Obtiene los símbolos del rotor en su orden original
+     * @return Puntero a getTamanio() símbolos (sin terminador)
+     */
+    const char* getAlfabeto() const { return alfabeto; }
+    
+    /**
+     * @brief Indica si unos símbolos sirven como alfabeto del rotor
+     * @param simbolos Símbolos en orden
+     * @param longitud Número de símbolos
+     * @return true si hay entre 2 y 256 símbolos y ninguno se repite
+     */
+    static bool esAlfabetoValido(const char* simbolos, int longitud);
+    
+    /**
+     * @brief Busca un alfabeto por nombre o lo toma literalmente
+     * @param nombre "prt7", "digitos", "minusculas", "bytes" o los símbolos
+     * @param simbolos Recibe los símbolos (memoria estática o 'nombre')
+     * @param longitud Recibe el número de símbolos
+     * @return false si no es un nombre conocido y no es un alfabeto válido
+     * 
+     * Una cadena literal no puede contener el byte 0, así que admite como
+     * mucho 255 símbolos; los 256 valores se piden con "bytes".
+     */
+    static bool buscarAlfabeto(const char* nombre, const char*& simbolos, int& longitud);
     
     /**
      * @brief Método auxiliar para debug - muestra el estado del rotor
+     * 
+     * Materializa 'cabeza' antes de recorrer la lista circular.
      */
     void mostrarRotor();
 };
@@ -5,6 +5,10 @@
 
 #include "SerialReader.h"
 #include <iostream>
+#include <cerrno>
+#include <cstring>
+#include "ParserTramas.h"
+#include "Metricas.h"
 
 #ifdef _WIN32
     #include <windows.h>
@@ -12,9 +16,40 @@
     #include <fcntl.h>
     #include <unistd.h>
     #include <termios.h>
+    #include <sys/uio.h>
+    #include <poll.h>
 #endif
 
-SerialReader::SerialReader(const char* nombrePuerto) : handle(0), conectado(false) {
+#ifndef _WIN32
+/**
+ * @brief Traduce baudios numéricos a la constante de termios
+ * @param baudios Velocidad solicitada
+ * @return Constante Bxxxx, o B0 si la plataforma no la soporta
+ */
+static speed_t velocidadTermios(int baudios) {
+    switch (baudios) {
+        case 9600:   return B9600;
+        case 19200:  return B19200;
+        case 38400:  return B38400;
+        case 57600:  return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+#ifdef B460800
+        case 460800: return B460800;
+#endif
+#ifdef B921600
+        case 921600: return B921600;
+#endif
+        default:     return B0;
+    }
+}
+#endif
+
+SerialReader::SerialReader(const char* nombrePuerto, const ConfiguracionSerial& configuracion)
+    : handle(0), conectado(false), config(configuracion), esTerminal(false), colgado(false),
+      longitudResto(0), inicio(0), fin(0), escaneado(0), finDeFlujo(false),
+      ultimaLectura(0), instanteLinea(0), formatoActivo(configuracion.formato),
+      numPendientes(0), siguientePendiente(0), rachaPendiente(false), offsetPendientes(0) {
     // Calcular longitud de la cadena
     int len = 0;
     while (nombrePuerto[len] != '\0') len++;
@@ -56,7 +91,7 @@ bool SerialReader::conectar() {
         return false;
     }
     
-    // Configurar parámetros del puerto (9600 baud, 8N1)
+    // Configurar parámetros del puerto (8N1 a la velocidad configurada)
     DCB dcbSerialParams = {0};
     dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
     
@@ -66,11 +101,21 @@ bool SerialReader::conectar() {
         return false;
     }
     
-    dcbSerialParams.BaudRate = CBR_9600;
+    dcbSerialParams.BaudRate = config.baudios;
     dcbSerialParams.ByteSize = 8;
     dcbSerialParams.StopBits = ONESTOPBIT;
     dcbSerialParams.Parity = NOPARITY;
     
+    if (config.modoCrudo) {
+        // Sin control de flujo por software ni reemplazo de bytes
+        dcbSerialParams.fBinary = TRUE;
+        dcbSerialParams.fParity = FALSE;
+        dcbSerialParams.fOutX = FALSE;
+        dcbSerialParams.fInX = FALSE;
+        dcbSerialParams.fErrorChar = FALSE;
+        dcbSerialParams.fNull = FALSE;
+    }
+    
     if (!SetCommState(hSerial, &dcbSerialParams)) {
         std::cerr << "Error al configurar puerto serial" << std::endl;
         CloseHandle(hSerial);
@@ -91,27 +136,62 @@ bool SerialReader::conectar() {
     
 #else
     // Linux/Mac: Usar termios
-    int fd = open(puerto, O_RDWR | O_NOCTTY | O_NDELAY);
+    int fd = open(puerto, O_RDWR | O_NOCTTY | O_NONBLOCK);
     
     if (fd == -1) {
         std::cerr << "Error: No se pudo abrir el puerto " << puerto << std::endl;
         return false;
     }
     
-    // Configurar termios para 9600 baud, 8N1
-    struct termios options;
-    tcgetattr(fd, &options);
-    
-    cfsetispeed(&options, B9600);
-    cfsetospeed(&options, B9600);
-    
-    options.c_cflag |= (CLOCAL | CREAD);
-    options.c_cflag &= ~PARENB;
-    options.c_cflag &= ~CSTOPB;
-    options.c_cflag &= ~CSIZE;
-    options.c_cflag |= CS8;
-    
-    tcsetattr(fd, TCSANOW, &options);
+    // Archivos y FIFOs no tienen configuración de línea
+    esTerminal = isatty(fd) != 0;
+    if (esTerminal) {
+        speed_t velocidad = velocidadTermios(config.baudios);
+        if (velocidad == B0) {
+            std::cerr << "Error: Velocidad no soportada: " << config.baudios << std::endl;
+            close(fd);
+            return false;
+        }
+        
+        // Configurar termios para la velocidad elegida, 8N1
+        struct termios options;
+        if (tcgetattr(fd, &options) != 0) {
+            std::cerr << "Error al obtener configuracion del puerto" << std::endl;
+            close(fd);
+            return false;
+        }
+        
+        cfsetispeed(&options, velocidad);
+        cfsetospeed(&options, velocidad);
+        
+        options.c_cflag |= (CLOCAL | CREAD);
+        options.c_cflag &= ~PARENB;
+        options.c_cflag &= ~CSTOPB;
+        options.c_cflag &= ~CSIZE;
+        options.c_cflag |= CS8;
+        
+        if (config.modoCrudo) {
+            // Equivalente a cfmakeraw(): sin eco, sin modo canónico, sin
+            // señales y sin traducción de CR/LF en entrada ni salida
+            options.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP |
+                                 INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
+            options.c_oflag &= ~OPOST;
+            options.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+            // read() nunca espera: el descriptor es no bloqueante y la
+            // espera la hace poll() en esperarDatos()
+            options.c_cc[VMIN] = 0;
+            options.c_cc[VTIME] = 0;
+        }
+        
+        if (tcsetattr(fd, TCSANOW, &options) != 0) {
+            std::cerr << "Error al configurar puerto serial" << std::endl;
+            close(fd);
+            return false;
+        }
+        
+        // Descartar lo que la disciplina de línea tuviera acumulado
+        tcflush(fd, TCIFLUSH);
+    }
     
     handle = (void*)(long)fd;
     conectado = true;
@@ -120,57 +200,322 @@ bool SerialReader::conectar() {
 #endif
 }
 
-bool SerialReader::leerLinea(char* buffer, int maxLen) {
-    if (!conectado) return false;
+int SerialReader::rellenar() {
+    unsigned int libres = TAM_ANILLO - (unsigned int)(fin - inicio);
+    if (libres == 0) return 0;
     
-    int pos = 0;
-    char c;
+    // Espacio libre: desde 'fin' hasta el final del arreglo y, si da la
+    // vuelta, desde el principio del arreglo hasta 'inicio'
+    unsigned int posFin = (unsigned int)(fin & (TAM_ANILLO - 1));
+    unsigned int tramo1 = TAM_ANILLO - posFin;
+    if (tramo1 > libres) tramo1 = libres;
+    unsigned int tramo2 = libres - tramo1;
     
 #ifdef _WIN32
-    HANDLE hSerial = (HANDLE)handle;
-    DWORD bytesRead;
+    // ReadFile no admite dos tramos: basta con el primero
+    (void)tramo2;
+    DWORD bytesRead = 0;
+    if (!ReadFile((HANDLE)handle, anillo + posFin, tramo1, &bytesRead, NULL)) {
+        finDeFlujo = true;
+        return -1;
+    }
+    int n = (int)bytesRead;
+#else
+    struct iovec tramos[2];
+    tramos[0].iov_base = anillo + posFin;
+    tramos[0].iov_len = tramo1;
+    tramos[1].iov_base = anillo;
+    tramos[1].iov_len = tramo2;
     
-    while (pos < maxLen - 1) {
-        if (!ReadFile(hSerial, &c, 1, &bytesRead, NULL)) {
-            return false;
+    int n = (int)readv((int)(long)handle, tramos, tramo2 > 0 ? 2 : 1);
+    
+    if (n == 0) {
+        // En una tty con VMIN=0 y VTIME=0, read() devuelve 0 cuando no hay
+        // datos; solo es el fin si poll() ya reportó el cuelgue. En archivos
+        // y FIFOs siempre es el fin.
+        if (esTerminal && !colgado) return 0;
+        finDeFlujo = true;
+        return -1;
+    }
+    if (n < 0) {
+        // Sin datos por ahora (puerto no bloqueante) o error real
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+        finDeFlujo = true;
+        return -1;
+    }
+#endif
+    
+    fin += n;
+    ultimaLectura = relojNs();
+    return n;
+}
+
+bool SerialReader::siguienteLinea(const char*& linea, size_t& longitud,
+                                  unsigned long long& offset) {
+    if (!conectado) return false;
+    
+    if (formatoActivo != FORMATO_TEXTO) {
+        if (formatoActivo == FORMATO_AUTO && !detectarFormato()) return false;
+        if (formatoActivo == FORMATO_BINARIO) return siguienteLineaBinaria(linea, longitud, offset);
+    }
+    
+    const unsigned long long mascara = TAM_ANILLO - 1;
+    
+    while (true) {
+        // Ignorar CR/LF al inicio
+        while (inicio != fin) {
+            char c = anillo[inicio & mascara];
+            if (c != '\n' && c != '\r') break;
+            inicio++;
         }
+        if (escaneado < inicio) escaneado = inicio;
         
-        if (bytesRead == 0) {
-            // No hay datos disponibles
-            if (pos > 0) break;  // Si ya leímos algo, devolver
-            return false;        // Si no, indicar que no hay línea
+        // Buscar el terminador solo en los bytes que no se han revisado,
+        // por tramos contiguos del anillo
+        bool completa = false;
+        while (escaneado != fin && escaneado - inicio < MAX_LINEA) {
+            size_t pos = (size_t)(escaneado & mascara);
+            size_t tramo = (size_t)(fin - escaneado);
+            if (tramo > TAM_ANILLO - pos) tramo = TAM_ANILLO - pos;
+            size_t restante = (size_t)(MAX_LINEA - (escaneado - inicio));
+            if (tramo > restante) tramo = restante;
+            
+            const char* terminador = buscarFinDeLinea(anillo + pos, anillo + pos + tramo);
+            escaneado += terminador - (anillo + pos);
+            if (terminador != anillo + pos + tramo) {
+                completa = true;
+                break;
+            }
         }
         
-        if (c == '\n' || c == '\r') {
-            if (pos > 0) break;  // Línea completa
-            continue;            // Ignorar CR/LF al inicio
+        // Línea demasiado larga: se entrega cortada
+        if (escaneado - inicio >= MAX_LINEA) completa = true;
+        
+        // Flujo terminado: lo que quede es la última línea
+        if (!completa && finDeFlujo && escaneado != inicio) completa = true;
+        
+        if (completa) {
+            longitud = (size_t)(escaneado - inicio);
+            offset = inicio;
+            
+            size_t pos = (size_t)(inicio & mascara);
+            if (pos + longitud <= TAM_ANILLO) {
+                // Caso normal: la línea es contigua dentro del anillo
+                linea = anillo + pos;
+            } else {
+                // La línea da la vuelta: se une en lineaPartida
+                size_t primera = TAM_ANILLO - pos;
+                std::memcpy(lineaPartida, anillo + pos, primera);
+                std::memcpy(lineaPartida + primera, anillo, longitud - primera);
+                linea = lineaPartida;
+            }
+            
+            inicio = escaneado;
+            instanteLinea = ultimaLectura;
+            return true;
         }
         
-        buffer[pos++] = c;
+        // Línea incompleta: se conserva y se intenta traer más bytes; si el
+        // flujo acaba de terminar, la siguiente vuelta la entrega como última
+        if (finDeFlujo) return false;
+        if (rellenar() == 0) return false;
     }
+}
+
+bool SerialReader::detectarFormato() {
+    const unsigned long long mascara = TAM_ANILLO - 1;
     
-#else
-    int fd = (int)(long)handle;
+    while (true) {
+        while (inicio != fin && (anillo[inicio & mascara] == '\n' || anillo[inicio & mascara] == '\r')) {
+            inicio++;
+        }
+        if (inicio != fin) {
+            bool binario = (unsigned char)anillo[inicio & mascara] == SYNC_BINARIO;
+            formatoActivo = binario ? FORMATO_BINARIO : FORMATO_TEXTO;
+            return true;
+        }
+        if (finDeFlujo || rellenar() <= 0) return false;
+    }
+}
+
+bool SerialReader::siguienteLineaBinaria(const char*& linea, size_t& longitud,
+                                         unsigned long long& offset) {
+    const unsigned long long mascara = TAM_ANILLO - 1;
+    TramaParseada trama;
     
-    while (pos < maxLen - 1) {
-        int n = read(fd, &c, 1);
-        
-        if (n <= 0) {
-            if (pos > 0) break;
-            return false;
+    while (siguientePendiente >= numPendientes) {
+        // CR/LF entre tramas se ignoran; cualquier otro byte suelto es un error
+        bool sueltos = false;
+        unsigned long long inicioSueltos = inicio;
+        while (inicio != fin) {
+            unsigned char c = (unsigned char)anillo[inicio & mascara];
+            if (c == SYNC_BINARIO) break;
+            if (c != '\n' && c != '\r' && !sueltos) {
+                sueltos = true;
+                inicioSueltos = inicio;
+            }
+            inicio++;
         }
         
-        if (c == '\n' || c == '\r') {
-            if (pos > 0) break;
-            continue;
+        bool corrupta = sueltos;
+        unsigned long long inicioCorrupta = inicioSueltos;
+        
+        if (!corrupta) {
+            if (inicio == fin) {
+                if (finDeFlujo) return false;
+                int leidos = rellenar();
+                if (leidos == 0) return false;
+                continue;
+            }
+            
+            // Vista contigua de la trama (se copia si da la vuelta al anillo)
+            size_t disponible = (size_t)(fin - inicio);
+            if (disponible > MAX_TRAMA_BINARIA) disponible = MAX_TRAMA_BINARIA;
+            size_t pos = (size_t)(inicio & mascara);
+            const char* datos = anillo + pos;
+            if (pos + disponible > TAM_ANILLO) {
+                size_t primera = TAM_ANILLO - pos;
+                std::memcpy(tramaContigua, anillo + pos, primera);
+                std::memcpy(tramaContigua + primera, anillo, disponible - primera);
+                datos = tramaContigua;
+            }
+            
+            TramaBinaria binaria;
+            long r = decodificarTramaBinaria(datos, disponible, binaria);
+            if (r == 0) {
+                // Trama incompleta: esperar más bytes o, al final, reportarla
+                if (!finDeFlujo) {
+                    int leidos = rellenar();
+                    if (leidos == 0) return false;
+                    continue;
+                }
+                corrupta = true;
+                inicioCorrupta = inicio;
+                inicio = fin;
+            } else if (r < 0) {
+                // Saltar este SYNC y buscar el siguiente
+                corrupta = true;
+                inicioCorrupta = inicio;
+                inicio++;
+            } else {
+                offset = inicio;
+                inicio += (unsigned long long)r;
+                
+                if (binaria.tipo == TRAMA_CARGA) {
+                    // Las cargas se entregan de a una en las siguientes vueltas
+                    numPendientes = binaria.numCargas;
+                    rachaPendiente = binaria.racha;
+                    std::memcpy(cargasPendientes, binaria.cargas, binaria.racha ? 1 : (size_t)binaria.numCargas);
+                    siguientePendiente = 0;
+                    offsetPendientes = offset;
+                    break;
+                }
+                
+                trama.tipo = binaria.tipo;
+                trama.rotacion = binaria.rotacion;
+                longitud = escribirLineaTexto(trama, lineaPartida);
+                linea = lineaPartida;
+                instanteLinea = ultimaLectura;
+                return true;
+            }
         }
         
-        buffer[pos++] = c;
+        // Línea que parsearLinea() rechaza como ERROR_BINARIO_CORRUPTO
+        lineaPartida[0] = (char)SYNC_BINARIO;
+        linea = lineaPartida;
+        longitud = 1;
+        offset = inicioCorrupta;
+        instanteLinea = ultimaLectura;
+        return true;
     }
+    
+    // Siguiente carga del último bloque
+    trama.tipo = TRAMA_CARGA;
+    trama.caracter = cargasPendientes[rachaPendiente ? 0 : siguientePendiente];
+    siguientePendiente++;
+    longitud = escribirLineaTexto(trama, lineaPartida);
+    linea = lineaPartida;
+    offset = offsetPendientes;
+    instanteLinea = ultimaLectura;
+    return true;
+}
+
+bool SerialReader::leerLinea(char* buffer, int maxLen) {
+    if (maxLen < 2) return false;
+    size_t maxLinea = (size_t)(maxLen - 1);
+    
+    // Primero lo que no cupo en la llamada anterior
+    if (longitudResto > 0) {
+        size_t n = longitudResto < maxLinea ? longitudResto : maxLinea;
+        std::memcpy(buffer, restoLinea, n);
+        buffer[n] = '\0';
+        longitudResto -= n;
+        std::memmove(restoLinea, restoLinea + n, longitudResto);
+        return true;
+    }
+    
+    const char* linea;
+    size_t longitud;
+    unsigned long long offset;
+    if (!siguienteLinea(linea, longitud, offset)) return false;
+    
+    // Si no cabe en el buffer del llamador, el resto se copia aparte: la
+    // línea puede no estar en el anillo (tramas PRT-7B traducidas a texto)
+    if (longitud > maxLinea) {
+        longitudResto = longitud - maxLinea;
+        std::memcpy(restoLinea, linea + maxLinea, longitudResto);
+        longitud = maxLinea;
+    }
+    
+    std::memcpy(buffer, linea, longitud);
+    buffer[longitud] = '\0';
+    return true;
+}
+
+int SerialReader::esperarDatos(int timeoutMs) {
+    if (!conectado || finDeFlujo) return -1;
+    
+#ifdef _WIN32
+    // ReadFile ya espera según COMMTIMEOUTS; se aprovecha para llenar el anillo
+    (void)timeoutMs;
+    int n = rellenar();
+    if (n < 0) return -1;
+    return n > 0 ? 1 : 0;
+#else
+    struct pollfd pfd;
+    pfd.fd = (int)(long)handle;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    
+    int r = poll(&pfd, 1, timeoutMs);
+    if (r < 0) {
+        // Una señal (ej. SIGUSR1) interrumpió la espera: no es un error
+        return errno == EINTR ? 0 : -1;
+    }
+    if (r == 0) return 0;
+    return registrarEventos(pfd.revents);
 #endif
+}
+
+int SerialReader::getDescriptor() const {
+#ifdef _WIN32
+    return -1;
+#else
+    return conectado ? (int)(long)handle : -1;
+#endif
+}
+
+int SerialReader::registrarEventos(short eventos) {
+#ifdef _WIN32
+    (void)eventos;
+    return 1;
+#else
+    if (eventos & POLLNVAL) return -1;
+    if (eventos & (POLLHUP | POLLERR)) colgado = true;
     
-    buffer[pos] = '\0';
-    return pos > 0;
+    // POLLHUP/POLLERR se reportan como "hay datos" para que read() detecte el fin
+    return 1;
+#endif
 }
 
 void SerialReader::cerrar() {
@@ -183,4 +528,10 @@ void SerialReader::cerrar() {
 #endif
     
     conectado = false;
+    inicio = fin = escaneado = 0;
+    longitudResto = 0;
+    finDeFlujo = false;
+    colgado = false;
+    formatoActivo = config.formato;
+    numPendientes = siguientePendiente = 0;
 }
\ No newline at end of file
@@ -8,6 +8,30 @@
 #ifndef SERIAL_READER_H
 #define SERIAL_READER_H
 
+#include <cstddef>
+#include "ProtocoloBinario.h"
+
+/**
+ * @struct ConfiguracionSerial
+ * @brief Parámetros de la línea serial que se aplican en conectar()
+ * 
+ * Los valores por defecto corresponden al transmisor original (9600 8N1)
+ * con la terminal en modo crudo. VMIN y VTIME no se configuran: el puerto
+ * se abre no bloqueante (termios los ignora) y es poll() quien decide
+ * cuándo leer, así que en modo crudo quedan en 0.
+ */
+struct ConfiguracionSerial {
+    int baudios;        ///< Velocidad en baudios (9600 ... 921600)
+    bool modoCrudo;     ///< true: sin eco, sin modo canónico ni traducción de CR/LF
+    FormatoTramas formato;  ///< Protocolo del flujo (por defecto se detecta al primer byte)
+    
+    /**
+     * @brief Constructor con la configuración por defecto
+     */
+    ConfiguracionSerial() : baudios(9600), modoCrudo(true),
+                            formato(FORMATO_AUTO) {}
+};
+
 /**
  * @class SerialReader
  * @brief Maneja la comunicación con el puerto serial del Arduino
@@ -16,10 +40,62 @@
  * En sistemas Windows usa la API de Win32, en Linux/Mac usa termios.
  */
 class SerialReader {
+public:
+    static const unsigned int MAX_LINEA = 256;    ///< Línea más larga que se entrega entera
+    
 private:
     void* handle;           ///< Handle del puerto (void* para independencia de plataforma)
     char* puerto;           ///< Nombre del puerto (ej. "COM3" o "/dev/ttyUSB0")
     bool conectado;         ///< Estado de la conexión
+    ConfiguracionSerial config; ///< Parámetros de línea usados al conectar
+    bool esTerminal;        ///< true si el puerto es una tty (read()==0 no indica fin)
+    bool colgado;           ///< true si poll() reportó que el otro extremo colgó
+    
+    static const unsigned int TAM_ANILLO = 4096;  ///< Capacidad del buffer (potencia de 2)
+    char anillo[TAM_ANILLO];    ///< Buffer circular con los bytes recibidos aún sin entregar
+    char lineaPartida[MAX_LINEA]; ///< Copia de una línea que da la vuelta al anillo
+    char restoLinea[MAX_LINEA]; ///< Final de una línea que no cupo en el buffer de leerLinea()
+    size_t longitudResto;       ///< Bytes de 'restoLinea' aún sin entregar
+    unsigned long long inicio;  ///< Bytes consumidos del flujo (se enmascara al indexar)
+    unsigned long long fin;     ///< Bytes recibidos del flujo (se enmascara al indexar)
+    unsigned long long escaneado; ///< Hasta dónde ya se buscó un fin de línea sin éxito
+    bool finDeFlujo;            ///< true si el puerto/archivo ya no entregará más datos
+    long long ultimaLectura;    ///< relojNs() de la última lectura con datos
+    long long instanteLinea;    ///< relojNs() de la lectura que completó la última línea
+    
+    FormatoTramas formatoActivo;    ///< Protocolo en uso (FORMATO_AUTO hasta el primer byte)
+    char tramaContigua[MAX_TRAMA_BINARIA];  ///< Copia de una trama binaria que da la vuelta al anillo
+    char cargasPendientes[MAX_CARGAS_BINARIAS]; ///< Cargas del último bloque binario
+    int numPendientes;          ///< Cargas que representa el último bloque
+    int siguientePendiente;     ///< Próxima carga del bloque a entregar
+    bool rachaPendiente;        ///< true si el bloque es una racha de cargasPendientes[0]
+    unsigned long long offsetPendientes; ///< Posición del bloque en el flujo
+    
+    /**
+     * @brief Trae del puerto todos los bytes disponibles que quepan en el anillo
+     * @return Bytes leídos, 0 si no había datos, -1 si el flujo terminó o falló
+     * 
+     * Hace una sola llamada al sistema por invocación (readv en Linux/Mac
+     * para llenar también el tramo que da la vuelta al anillo).
+     */
+    int rellenar();
+    
+    /**
+     * @brief Decide el protocolo por el primer byte que no sea CR/LF
+     * @return false si todavía no llegó ningún byte
+     */
+    bool detectarFormato();
+    
+    /**
+     * @brief siguienteLinea() para el formato binario
+     * 
+     * Cada trama se entrega como la línea de texto equivalente ("L,X",
+     * "M,N", "FIN"), una por carga, así que quien consume las líneas no
+     * distingue el formato. Una trama inválida o bytes fuera de trama se
+     * entregan como una línea que empieza con SYNC_BINARIO, que
+     * parsearLinea() rechaza con ERROR_BINARIO_CORRUPTO.
+     */
+    bool siguienteLineaBinaria(const char*& linea, size_t& longitud, unsigned long long& offset);
     
     /**
      * @brief Copia una cadena manualmente (sin usar std::string)
@@ -32,8 +108,10 @@ public:
     /**
      * @brief Constructor que inicializa con el nombre del puerto
      * @param nombrePuerto Nombre del puerto serial (ej. "COM3")
+     * @param configuracion Velocidad y modo de la línea (por defecto 9600, crudo)
      */
-    SerialReader(const char* nombrePuerto);
+    SerialReader(const char* nombrePuerto,
+                 const ConfiguracionSerial& configuracion = ConfiguracionSerial());
     
     /**
      * @brief Destructor que cierra la conexión
@@ -43,6 +121,11 @@ public:
     /**
      * @brief Abre y configura el puerto serial
      * @return true si se conectó exitosamente, false en caso contrario
+     * 
+     * Aplica la ConfiguracionSerial recibida en el constructor. En modo
+     * crudo la terminal no hace eco, no espera líneas completas y no
+     * traduce bytes (equivalente a cfmakeraw). Si el nombre no es una
+     * terminal (ej. un archivo o FIFO) se abre sin tocar la configuración.
      */
     bool conectar();
     
@@ -52,10 +135,89 @@ public:
      * @param maxLen Tamaño máximo del buffer
      * @return true si se leyó una línea completa, false si no hay datos
      * 
-     * Lee hasta encontrar '\n' o hasta llenar el buffer.
+     * Lee hasta encontrar '\n' o hasta llenar el buffer. Los bytes se traen
+     * del puerto en bloques hacia un buffer circular interno, así que una
+     * ráfaga de muchas tramas cuesta una sola llamada al sistema. Los CR/LF
+     * al inicio de una línea se ignoran; una línea incompleta se conserva
+     * en el buffer hasta que llegue su terminador (o hasta que el flujo
+     * termine, en cuyo caso se entrega tal cual). Si la línea no cabe en
+     * 'buffer', lo que sobra se guarda aparte y se entrega en las llamadas
+     * siguientes.
      */
     bool leerLinea(char* buffer, int maxLen);
     
+    /**
+     * @brief Entrega la siguiente línea como vista sobre el buffer interno
+     * @param linea Recibe el inicio de la línea (sin terminador ni '\0')
+     * @param longitud Recibe el número de bytes de la línea
+     * @param offset Recibe la posición del primer byte en el flujo
+     * @return true si hay una línea completa, false si no hay datos
+     * 
+     * Igual que leerLinea() pero sin copiar: la línea apunta al anillo
+     * (solo se copia si da la vuelta al final del arreglo). La vista es
+     * válida hasta la siguiente llamada a cualquier método de lectura o
+     * espera. Las líneas de más de MAX_LINEA bytes se entregan en partes.
+     */
+    bool siguienteLinea(const char*& linea, size_t& longitud, unsigned long long& offset);
+    
+    /**
+     * @brief Bloquea hasta que el puerto tenga datos nuevos o pase el tiempo indicado
+     * @param timeoutMs Tiempo máximo de espera en milisegundos (-1 = sin límite)
+     * @return 1 si hay datos para leer, 0 si expiró el tiempo o una señal
+     *         interrumpió la espera, -1 si el flujo terminó o el puerto falló
+     * 
+     * En Linux/Mac usa poll() sobre el descriptor no bloqueante; en Windows
+     * espera dentro de ReadFile según los timeouts del puerto.
+     */
+    int esperarDatos(int timeoutMs);
+    
+    /**
+     * @brief Descriptor del puerto, para esperar varios puertos en un solo poll()
+     * @return Descriptor abierto, o -1 si no está conectado (siempre -1 en Windows)
+     */
+    int getDescriptor() const;
+    
+    /**
+     * @brief Interpreta los eventos que poll() devolvió para este puerto
+     * @param eventos Campo revents de la pollfd del puerto
+     * @return 1 si hay que intentar leer, -1 si el descriptor no es válido
+     * 
+     * Hace lo mismo que esperarDatos() tras su propio poll(): un cuelgue o
+     * error se anota para que la siguiente lectura detecte el fin del flujo.
+     */
+    int registrarEventos(short eventos);
+    
+    /**
+     * @brief Indica si el flujo ya no entregará más líneas
+     * @return true si el puerto no está conectado o llegó al fin
+     */
+    bool flujoTerminado() const { return !conectado || (finDeFlujo && inicio == fin); }
+    
+    /**
+     * @brief Instante en que se leyó del puerto la última línea entregada
+     * @return relojNs() de la lectura que trajo su terminador
+     * 
+     * Vale para la línea devuelta por la última llamada a siguienteLinea()
+     * o leerLinea(). Como solo se lee cuando no quedan líneas completas, es
+     * siempre la lectura más reciente.
+     */
+    long long getInstanteLinea() const { return instanteLinea; }
+    
+    /**
+     * @brief Bytes del flujo ya retirados del buffer
+     * @return Posición en el flujo del primer byte aún sin procesar (en
+     *         PRT-7B puede incluir tramas ya leídas cuyas cargas faltan
+     *         por entregar)
+     */
+    unsigned long long getConsumidos() const { return inicio; }
+    
+    /**
+     * @brief Protocolo del flujo
+     * @return FORMATO_TEXTO o FORMATO_BINARIO, o FORMATO_AUTO si aún no
+     *         llegó ningún byte
+     */
+    FormatoTramas getFormato() const { return formatoActivo; }
+    
     /**
      * @brief Cierra el puerto serial
      */
@@ -0,0 +1,269 @@
+/**
+ * @file SesionesMultiples.cpp
+ * @brief Implementación del bucle de sesiones múltiples
+ */
+
+#include "SesionesMultiples.h"
+#include "SerialReader.h"
+#include "Decodificador.h"
+#include "TramaBase.h"
+#include "SumideroCarga.h"
+#include "BuscadorPalabras.h"
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+#include <cerrno>
+
+#ifndef _WIN32
+    #include <poll.h>
+#endif
+
+namespace {
+
+/**
+ * @struct Sesion
+ * @brief Un transmisor con su lector y su estado de decodificación
+ */
+struct Sesion {
+    const char* nombre;             ///< Puerto o archivo tal como se indicó
+    SerialReader* serial;           ///< Lector propio del puerto
+    Decodificador* decodificador;   ///< Rotor y mensaje propios
+    SumideroDescriptor* salida;     ///< Archivo del modo streaming, o 0
+    Metricas* metricas;             ///< Contadores y latencias propios, o 0
+    AvisoCoincidencias* avisos;     ///< Alertas con el nombre de la sesión, o 0
+    BuscadorPalabras* buscador;     ///< Palabras vigiladas en su mensaje, o 0
+    bool activa;                    ///< false cuando el flujo terminó
+    bool pendiente;                 ///< Agotó su turno con líneas por procesar
+};
+
+/// Líneas que procesa una sesión por turno antes de ceder a las demás
+const int LINEAS_POR_TURNO = 4096;
+
+/**
+ * @brief Procesa las líneas completas de una sesión, hasta LINEAS_POR_TURNO
+ * @param sesion Sesión a drenar (marca 'pendiente' si le quedan líneas)
+ * @param indice Posición de la sesión (para los encabezados)
+ * @param ultimaMostrada Sesión del último encabezado impreso (se actualiza)
+ */
+void drenarSesion(Sesion& sesion, int indice, int& ultimaMostrada) {
+    const char* linea;
+    size_t longitud;
+    unsigned long long offset;
+    bool silencioso = TramaBase::getModoSalida() == SALIDA_SILENCIOSA;
+
+    // Un turno acotado: un archivo o un transmisor rápido no acapara el
+    // bucle ni retrasa las señales
+    int turno = 0;
+    sesion.pendiente = false;
+    while (sesion.serial->siguienteLinea(linea, longitud, offset)) {
+        // En modo silencioso solo FIN imprime algo (el mensaje completo)
+        bool imprime = !silencioso ||
+                       (longitud == 3 && linea[0] == 'F' && linea[1] == 'I' && linea[2] == 'N');
+        if (imprime && ultimaMostrada != indice) {
+            std::cout << "=== [" << sesion.nombre << "] ===" << std::endl;
+            ultimaMostrada = indice;
+        }
+        sesion.decodificador->marcarLlegada(sesion.serial->getInstanteLinea());
+        sesion.decodificador->procesarLinea(linea, longitud, offset);
+        if (++turno == LINEAS_POR_TURNO) {
+            sesion.pendiente = true;
+            return;
+        }
+    }
+
+    // No quedan líneas completas: no retener el lote
+    sesion.decodificador->vaciarLote();
+    if (sesion.serial->flujoTerminado()) sesion.activa = false;
+}
+
+/**
+ * @brief Vuelca las métricas de todas las sesiones en una misma ronda
+ * @param publicador Destino de las métricas
+ * @param sesiones Sesiones a volcar
+ * @param total Número de sesiones
+ */
+void publicarSesiones(PublicadorMetricas& publicador, Sesion* sesiones, int total) {
+    for (int i = 0; i < total; i++) {
+        if (sesiones[i].metricas) publicador.publicar(*sesiones[i].metricas, sesiones[i].nombre);
+    }
+    publicador.terminarRonda();
+}
+
+} // namespace
+
+int decodificarSesiones(const Opciones& opciones, volatile std::sig_atomic_t& solicitudMensaje,
+                        PublicadorMetricas* metricas) {
+#ifdef _WIN32
+    (void)opciones;
+    (void)solicitudMensaje;
+    (void)metricas;
+    std::cerr << "Error: Varios puertos a la vez solo estan disponibles en Linux/Mac" << std::endl;
+    return 1;
+#else
+    int total = opciones.numPuertos;
+    Sesion* sesiones = new Sesion[total];
+    int activas = 0;
+
+    std::cout << "Iniciando Decodificador PRT-7. Conectando a " << total << " puertos..." << std::endl;
+    for (int i = 0; i < total; i++) {
+        sesiones[i].nombre = opciones.puertos[i];
+        sesiones[i].serial = new SerialReader(opciones.puertos[i], opciones.serial);
+        sesiones[i].decodificador = new Decodificador(opciones.capacidadBloque, opciones.alfabeto,
+                                                    opciones.longitudAlfabeto);
+        sesiones[i].decodificador->setReiniciarRotorEnFin(opciones.reiniciarRotor);
+        sesiones[i].salida = 0;
+        sesiones[i].pendiente = false;
+        sesiones[i].metricas = metricas ? new Metricas : 0;
+        sesiones[i].decodificador->setMetricas(sesiones[i].metricas);
+        sesiones[i].avisos = 0;
+        sesiones[i].buscador = 0;
+        if (opciones.numVigiladas > 0) {
+            sesiones[i].avisos = new AvisoCoincidencias(sesiones[i].nombre);
+            sesiones[i].buscador = new BuscadorPalabras(sesiones[i].avisos);
+            for (int k = 0; k < opciones.numVigiladas; k++) {
+                sesiones[i].buscador->agregarPalabra(opciones.vigiladas[k],
+                                                     std::strlen(opciones.vigiladas[k]));
+            }
+            sesiones[i].buscador->compilar();
+            sesiones[i].decodificador->getLista().setBuscador(sesiones[i].buscador);
+        }
+        sesiones[i].activa = sesiones[i].serial->conectar();
+
+        // Modo streaming: un archivo por sesión (RUTA.N)
+        if (sesiones[i].activa && opciones.sumidero) {
+            char ruta[1024];
+            std::snprintf(ruta, sizeof(ruta), "%s.%d", opciones.sumidero, i);
+            sesiones[i].salida = new SumideroDescriptor;
+            if (sesiones[i].salida->abrir(ruta)) {
+                sesiones[i].decodificador->getLista().setSumidero(sesiones[i].salida, opciones.ventana);
+            } else {
+                sesiones[i].serial->cerrar();
+                sesiones[i].activa = false;
+            }
+        }
+
+        if (sesiones[i].activa) {
+            activas++;
+        } else {
+            std::cerr << "Error: No se pudo conectar a " << sesiones[i].nombre << std::endl;
+        }
+    }
+
+    if (activas == 0) {
+        for (int i = 0; i < total; i++) {
+            delete sesiones[i].serial;
+            delete sesiones[i].decodificador;
+            delete sesiones[i].salida;
+            delete sesiones[i].metricas;
+            delete sesiones[i].buscador;
+            delete sesiones[i].avisos;
+        }
+        delete[] sesiones;
+        return 1;
+    }
+
+    std::cout << "Conexion establecida con " << activas << " puertos. Esperando tramas..." << std::endl;
+    std::cout << std::endl;
+
+    struct pollfd* descriptores = new struct pollfd[total];
+    int* sesionDe = new int[total];
+    int ultimaMostrada = -1;
+
+    while (activas > 0) {
+        // Solo se espera sobre las sesiones que siguen abiertas
+        int n = 0;
+        bool hayPendientes = false;
+        for (int i = 0; i < total; i++) {
+            if (!sesiones[i].activa) continue;
+            if (sesiones[i].pendiente) hayPendientes = true;
+            descriptores[n].fd = sesiones[i].serial->getDescriptor();
+            descriptores[n].events = POLLIN;
+            descriptores[n].revents = 0;
+            sesionDe[n] = i;
+            n++;
+        }
+
+        // Con líneas ya leídas pendientes no se espera: solo se revisan eventos
+        int r = poll(descriptores, (nfds_t)n, hayPendientes ? 0 : opciones.esperaMs);
+        if (r < 0 && errno != EINTR) {
+            std::cerr << "Error: Fallo la espera sobre los puertos" << std::endl;
+            break;
+        }
+
+        // Un turno por sesión con datos, en orden
+        for (int k = 0; k < n; k++) {
+            Sesion& sesion = sesiones[sesionDe[k]];
+            if (r <= 0) descriptores[k].revents = 0;
+            if (descriptores[k].revents == 0 && !sesion.pendiente) continue;
+
+            if (descriptores[k].revents != 0 &&
+                sesion.serial->registrarEventos(descriptores[k].revents) < 0) {
+                sesion.activa = false;
+            } else {
+                drenarSesion(sesion, sesionDe[k], ultimaMostrada);
+            }
+
+            if (!sesion.activa) {
+                sesion.serial->cerrar();
+                activas--;
+            }
+        }
+
+        // Mensajes acumulados bajo demanda (SIGUSR1)
+        if (solicitudMensaje) {
+            solicitudMensaje = 0;
+            for (int i = 0; i < total; i++) {
+                std::cout << "[Mensaje parcial " << sesiones[i].nombre << ": ";
+                sesiones[i].decodificador->imprimirMensaje();
+                std::cout << "]" << std::endl;
+            }
+        }
+        
+        // Métricas bajo demanda (SIGUSR2) o periódicas
+        if (metricas && metricas->pendiente()) publicarSesiones(*metricas, sesiones, total);
+    }
+
+    delete[] sesionDe;
+    delete[] descriptores;
+
+    // Mostrar resultado final de cada sesión
+    std::cout << std::endl;
+    std::cout << "---" << std::endl;
+    std::cout << "Flujo de datos terminado (" << total << " sesiones)." << std::endl;
+    for (int i = 0; i < total; i++) sesiones[i].decodificador->vaciarLote();
+    if (metricas) publicarSesiones(*metricas, sesiones, total);
+    for (int i = 0; i < total; i++) {
+        Decodificador* decodificador = sesiones[i].decodificador;
+        decodificador->vaciarLote();
+        ListaDeCarga& lista = decodificador->getLista();
+        if (sesiones[i].salida) {
+            if (!lista.estaVacia() || lista.getVolcados() > 0) lista.cerrarMensaje();
+            sesiones[i].salida->vaciar();
+        } else if (decodificador->getMensajesCompletos() == 0 || !lista.estaVacia()) {
+            std::cout << "MENSAJE OCULTO ENSAMBLADO [" << sesiones[i].nombre << "]:" << std::endl;
+            decodificador->imprimirMensaje();
+            std::cout << std::endl;
+        }
+        if (decodificador->getMensajesCompletos() > 0) {
+            std::cout << "Mensajes completos [" << sesiones[i].nombre << "]: "
+                      << decodificador->getMensajesCompletos() << std::endl;
+        }
+        if (sesiones[i].buscador) {
+            std::cout << "Coincidencias [" << sesiones[i].nombre << "]: "
+                      << sesiones[i].buscador->getCoincidencias() << std::endl;
+        }
+
+        delete sesiones[i].serial;
+        delete sesiones[i].decodificador;
+        delete sesiones[i].salida;
+        delete sesiones[i].metricas;
+        delete sesiones[i].buscador;
+        delete sesiones[i].avisos;
+    }
+    std::cout << "---" << std::endl;
+    std::cout << "Liberando memoria... Sistema apagado." << std::endl;
+
+    delete[] sesiones;
+    return 0;
+#endif
+}
@@ -0,0 +1,37 @@
+/**
+ * @file SesionesMultiples.h
+ * @brief Decodificación simultánea de varios transmisores en un solo hilo
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef SESIONES_MULTIPLES_H
+#define SESIONES_MULTIPLES_H
+
+#include <csignal>
+#include "Opciones.h"
+#include "Metricas.h"
+
+/**
+ * @brief Decodifica todos los puertos de las opciones desde un único poll()
+ * @param opciones Opciones (usa puertos, serial, esperaMs y capacidadBloque)
+ * @param solicitudMensaje Bandera de SIGUSR1; al activarse se imprimen los
+ *        mensajes parciales de todas las sesiones y se desactiva
+ * @param metricas Publicador de métricas, o 0 para no medir. Cada sesión
+ *        tiene las suyas y se vuelcan juntas, con el nombre de la sesión
+ * @return 0 si terminó normalmente, 1 si no se pudo abrir ningún puerto
+ *
+ * Cada puerto (o archivo) es una sesión independiente con su propio
+ * SerialReader y su propio Decodificador, es decir, su propio rotor y su
+ * propia lista de carga. Un solo bucle espera a la vez sobre todos los
+ * descriptores y drena solo los que tienen datos, así que un proceso atiende
+ * decenas de transmisores sin un hilo por puerto. Los diagnósticos por trama
+ * se encabezan con el nombre de la sesión cuando cambia de una a otra.
+ *
+ * Al terminar todas las sesiones imprime el mensaje de cada una. Solo está
+ * disponible en Linux/Mac.
+ */
+int decodificarSesiones(const Opciones& opciones, volatile std::sig_atomic_t& solicitudMensaje,
+                        PublicadorMetricas* metricas);
+
+#endif // SESIONES_MULTIPLES_H
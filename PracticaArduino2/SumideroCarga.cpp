@@ -0,0 +1,143 @@
+/**
+ * @file SumideroCarga.cpp
+ * @brief Implementación de los sumideros de mensaje
+ */
+
+#include "SumideroCarga.h"
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+SumideroDescriptor::SumideroDescriptor(int fd)
+    : descriptor(fd), propio(false), buffer(new char[TAM_BUFFER]), usados(0), escritos(0),
+      bytesArchivo(0) {}
+
+SumideroDescriptor::~SumideroDescriptor() {
+    vaciar();
+    if (propio && descriptor >= 0) {
+#ifdef _WIN32
+        _close(descriptor);
+#else
+        close(descriptor);
+#endif
+    }
+    delete[] buffer;
+}
+
+bool SumideroDescriptor::abrir(const char* ruta) {
+#ifdef _WIN32
+    int fd = _open(ruta, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    int fd = open(ruta, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    if (fd < 0) {
+        std::cerr << "Error: No se pudo crear " << ruta << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    vaciar();
+    descriptor = fd;
+    propio = true;
+    bytesArchivo = 0;
+    return true;
+}
+
+bool SumideroDescriptor::reabrir(const char* ruta, unsigned long long longitud) {
+#ifdef _WIN32
+    int fd = _open(ruta, _O_WRONLY | _O_BINARY | (longitud == 0 ? _O_CREAT : 0),
+                   _S_IREAD | _S_IWRITE);
+#else
+    int fd = open(ruta, O_WRONLY | (longitud == 0 ? O_CREAT : 0), 0644);
+#endif
+    if (fd < 0) {
+        std::cerr << "Error: No se pudo abrir " << ruta << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Descartar lo escrito después de la instantánea
+#ifdef _WIN32
+    bool valido = (unsigned long long)_lseeki64(fd, 0, SEEK_END) >= longitud &&
+                  _chsize_s(fd, (long long)longitud) == 0 &&
+                  _lseeki64(fd, 0, SEEK_END) >= 0;
+#else
+    off_t actual = lseek(fd, 0, SEEK_END);
+    bool valido = actual >= 0 && (unsigned long long)actual >= longitud &&
+                  ftruncate(fd, (off_t)longitud) == 0 &&
+                  lseek(fd, 0, SEEK_END) >= 0;
+#endif
+    if (!valido) {
+        std::cerr << "Error: " << ruta << " no conserva los " << longitud
+                  << " bytes de la instantanea" << std::endl;
+#ifdef _WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+        return false;
+    }
+
+    vaciar();
+    descriptor = fd;
+    propio = true;
+    bytesArchivo = longitud;
+    return true;
+}
+
+bool SumideroDescriptor::sincronizar() {
+    vaciar();
+    if (descriptor < 0) return false;
+#ifdef _WIN32
+    return _commit(descriptor) == 0;
+#else
+    return fsync(descriptor) == 0;
+#endif
+}
+
+void SumideroDescriptor::escribir(const char* datos, size_t n) {
+    escritos += n;
+
+    while (n > 0) {
+        size_t libres = TAM_BUFFER - usados;
+        size_t copiar = n < libres ? n : libres;
+        std::memcpy(buffer + usados, datos, copiar);
+        usados += copiar;
+        datos += copiar;
+        n -= copiar;
+
+        if (usados == TAM_BUFFER) vaciar();
+    }
+}
+
+void SumideroDescriptor::finMensaje() {
+    if (usados == TAM_BUFFER) vaciar();
+    buffer[usados++] = '\n';
+    vaciar();
+}
+
+void SumideroDescriptor::vaciar() {
+    size_t hecho = 0;
+    while (descriptor >= 0 && hecho < usados) {
+#ifdef _WIN32
+        int r = _write(descriptor, buffer + hecho, (unsigned int)(usados - hecho));
+#else
+        ssize_t r = write(descriptor, buffer + hecho, usados - hecho);
+#endif
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: No se pudo escribir el mensaje: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        hecho += (size_t)r;
+        bytesArchivo += (unsigned long long)r;
+    }
+    usados = 0;
+}
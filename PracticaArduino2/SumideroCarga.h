@@ -0,0 +1,151 @@
+/**
+ * @file SumideroCarga.h
+ * @brief Destinos a los que ListaDeCarga vuelca el mensaje en modo streaming
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef SUMIDERO_CARGA_H
+#define SUMIDERO_CARGA_H
+
+#include <cstddef>
+
+/**
+ * @class SumideroCarga
+ * @brief Interfaz de salida para la parte del mensaje que ya no se retiene
+ *
+ * En modo streaming ListaDeCarga solo conserva una ventana con el final
+ * del mensaje; lo anterior se entrega aquí en orden, por bloques.
+ */
+class SumideroCarga {
+public:
+    /**
+     * @brief Destructor virtual para uso polimórfico
+     */
+    virtual ~SumideroCarga() {}
+
+    /**
+     * @brief Recibe caracteres del mensaje, en orden
+     * @param datos Caracteres decodificados
+     * @param n Número de caracteres
+     */
+    virtual void escribir(const char* datos, size_t n) = 0;
+
+    /**
+     * @brief Marca el final de un mensaje (trama FIN o fin del flujo)
+     */
+    virtual void finMensaje() = 0;
+
+    /**
+     * @brief Entrega lo que el sumidero tenga en buffers propios
+     */
+    virtual void vaciar() {}
+};
+
+/**
+ * @class SumideroDescriptor
+ * @brief Escribe el mensaje en un descriptor de archivo con un buffer grande
+ *
+ * Acumula hasta TAM_BUFFER bytes antes de cada write(), así que volcar
+ * nodos de un carácter no cuesta una llamada al sistema por carácter.
+ * Cada mensaje termina con un salto de línea.
+ */
+class SumideroDescriptor : public SumideroCarga {
+public:
+    static const size_t TAM_BUFFER = 64 * 1024;    ///< Bytes por escritura
+
+private:
+    int descriptor;             ///< Destino, o -1 si no está abierto
+    bool propio;                ///< true si hay que cerrarlo al terminar
+    char* buffer;               ///< Bytes pendientes de escribir
+    size_t usados;              ///< Bytes ocupados en 'buffer'
+    unsigned long long escritos; ///< Caracteres de mensaje recibidos en total
+    unsigned long long bytesArchivo; ///< Bytes ya escritos en el descriptor
+
+    // No se permite copiar: posee el descriptor y el buffer
+    SumideroDescriptor(const SumideroDescriptor&);
+    SumideroDescriptor& operator=(const SumideroDescriptor&);
+
+public:
+    /**
+     * @brief Constructor
+     * @param fd Descriptor ya abierto (ej. 1 para la salida estándar), o -1
+     *
+     * El descriptor recibido no se cierra al destruir el sumidero.
+     */
+    SumideroDescriptor(int fd = -1);
+
+    /**
+     * @brief Destructor que vacía el buffer y cierra el archivo propio
+     */
+    ~SumideroDescriptor();
+
+    /**
+     * @brief Crea (o trunca) un archivo y escribe en él
+     * @param ruta Ruta del archivo de salida
+     * @return true si se pudo abrir
+     */
+    bool abrir(const char* ruta);
+
+    /**
+     * @brief Abre un archivo ya empezado y sigue escribiendo al final
+     * @param ruta Ruta del archivo de salida
+     * @param longitud Bytes que se conservan; lo que haya después se descarta
+     * @return false si no se pudo abrir o tiene menos de 'longitud' bytes
+     *
+     * Sirve para reanudar desde una instantánea: lo escrito después de
+     * tomarla se vuelve a generar, así que no queda duplicado.
+     */
+    bool reabrir(const char* ruta, unsigned long long longitud);
+
+    /**
+     * @brief Vacía el buffer y espera a que el archivo llegue al disco
+     * @return false si el sistema no pudo confirmar la escritura
+     */
+    bool sincronizar();
+
+    void escribir(const char* datos, size_t n);
+    void finMensaje();
+    void vaciar();
+
+    /**
+     * @brief Caracteres de mensaje recibidos (sin contar separadores)
+     * @return Total entregado al sumidero
+     */
+    unsigned long long getEscritos() const { return escritos; }
+
+    /**
+     * @brief Bytes del archivo, separadores incluidos (sin el buffer pendiente)
+     * @return Longitud que tendrá el archivo tras sincronizar()
+     */
+    unsigned long long getBytesArchivo() const { return bytesArchivo + usados; }
+};
+
+/// Callback de SumideroFuncion; n == 0 (datos == 0) marca el fin de un mensaje
+typedef void (*FuncionSumidero)(const char* datos, size_t n, void* contexto);
+
+/**
+ * @class SumideroFuncion
+ * @brief Entrega el mensaje a una función del programa
+ *
+ * Útil para encadenar otra etapa (ej. escribir por std::cout para que el
+ * mensaje respete el orden de los diagnósticos) sin pasar por un archivo.
+ */
+class SumideroFuncion : public SumideroCarga {
+private:
+    FuncionSumidero funcion;    ///< Destino de los caracteres
+    void* contexto;             ///< Dato opaco que se pasa a 'funcion'
+
+public:
+    /**
+     * @brief Constructor
+     * @param f Función que recibe los bloques del mensaje
+     * @param ctx Dato que se le pasa en cada llamada
+     */
+    SumideroFuncion(FuncionSumidero f, void* ctx = 0) : funcion(f), contexto(ctx) {}
+
+    void escribir(const char* datos, size_t n) { funcion(datos, n, contexto); }
+    void finMensaje() { funcion(0, 0, contexto); }
+};
+
+#endif // SUMIDERO_CARGA_H
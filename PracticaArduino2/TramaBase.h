@@ -12,13 +12,30 @@
 class ListaDeCarga;
 class RotorDeMapeo;
 
+/**
+ * @enum ModoSalida
+ * @brief Nivel de detalle de los diagnósticos que imprime cada trama
+ */
+enum ModoSalida {
+    SALIDA_COMPLETA,    ///< Cada carga reimprime el mensaje completo (depuración)
+    SALIDA_FRAGMENTO,   ///< Cada trama imprime solo su propio resultado
+    SALIDA_SILENCIOSA   ///< Sin diagnósticos por trama (producción)
+};
+
 /**
  * @class TramaBase
  * @brief Clase abstracta que define la interfaz para todas las tramas del protocolo PRT-7
  * 
- * Esta clase sirve como base polimórfica para los dos tipos de tramas:
+ * Esta clase sirve como base polimórfica para los tipos de tramas:
  * - TramaLoad: Carga datos
  * - TramaMap: Modifica el rotor de mapeo
+ * - TramaFin: Cierra el mensaje actual ("FIN")
+ * - TramaLote: Racha de cargas seguidas que Decodificador agrupa en una
+ *   sola trama (no llega por el puerto)
+ * 
+ * También guarda el ModoSalida que todas consultan para decidir cuánto
+ * diagnóstico imprimen (setModoSalida()/getModoSalida(), compartido a
+ * través de modoActual()).
  */
 class TramaBase {
 public:
@@ -40,6 +57,28 @@ public:
      * Define el comportamiento específico de cada tipo de trama.
      */
     virtual void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) = 0;
+    
+    /**
+     * @brief Selecciona el nivel de diagnóstico de todas las tramas
+     * @param modo Modo de salida a usar a partir de ahora
+     */
+    static void setModoSalida(ModoSalida modo) { modoActual() = modo; }
+    
+    /**
+     * @brief Obtiene el nivel de diagnóstico actual
+     * @return Modo de salida vigente (por defecto SALIDA_COMPLETA)
+     */
+    static ModoSalida getModoSalida() { return modoActual(); }
+    
+private:
+    /**
+     * @brief Almacenamiento compartido del modo de salida
+     * @return Referencia al modo vigente
+     */
+    static ModoSalida& modoActual() {
+        static ModoSalida modo = SALIDA_COMPLETA;
+        return modo;
+    }
 };
 
 #endif // TRAMA_BASE_H
\ No newline at end of file
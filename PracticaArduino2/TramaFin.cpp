@@ -0,0 +1,27 @@
+/**
+ * @file TramaFin.cpp
+ * @brief Implementación de la clase TramaFin
+ */
+
+#include "TramaFin.h"
+#include <iostream>
+
+void TramaFin::procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
+    if (getModoSalida() != SALIDA_SILENCIOSA) {
+        std::cout << "FIN DE MENSAJE" << std::endl;
+    }
+    
+    // Entregar el mensaje completo: al sumidero si la lista tiene uno
+    if (carga->getSumidero()) {
+        carga->cerrarMensaje();
+    } else {
+        std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
+        carga->imprimirMensaje();
+        std::cout << std::endl;
+        std::cout << "---" << std::endl;
+        carga->vaciar();
+    }
+    
+    // Empezar el siguiente mensaje desde cero
+    if (reiniciarRotor) rotor->reiniciar();
+}
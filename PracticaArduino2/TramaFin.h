@@ -0,0 +1,52 @@
+/**
+ * @file TramaFin.h
+ * @brief Clase derivada que representa la marca de fin de mensaje (FIN)
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef TRAMA_FIN_H
+#define TRAMA_FIN_H
+
+#include "TramaBase.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+
+/**
+ * @class TramaFin
+ * @brief Trama que cierra el mensaje actual y empieza uno nuevo
+ * 
+ * Formato: "FIN". Al procesarse, entrega el mensaje ensamblado (por consola
+ * o, en modo streaming, al sumidero de la lista), vacía la lista de carga
+ * y, si se pidió, devuelve el rotor a su posición inicial.
+ * Así una sesión puede recibir una secuencia indefinida de mensajes sin
+ * que la memoria crezca.
+ */
+class TramaFin : public TramaBase {
+private:
+    bool reiniciarRotor;    ///< true si el rotor vuelve a 'A' tras el mensaje
+    
+public:
+    /**
+     * @brief Constructor
+     * @param reiniciar true para reiniciar el rotor al cerrar el mensaje
+     */
+    TramaFin(bool reiniciar) : reiniciarRotor(reiniciar) {}
+    
+    /**
+     * @brief Destructor (usa el de la clase base)
+     */
+    ~TramaFin() {}
+    
+    /**
+     * @brief Procesa la trama: imprime el mensaje y lo descarta
+     * @param carga Lista con el mensaje completo (queda vacía)
+     * @param rotor Rotor que se reinicia si corresponde
+     * 
+     * El mensaje se imprime en cualquier modo de salida: es el resultado
+     * de la sesión, no un diagnóstico.
+     */
+    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor);
+};
+
+#endif // TRAMA_FIN_H
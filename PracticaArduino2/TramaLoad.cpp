@@ -14,8 +14,21 @@ void TramaLoad::procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
     carga->insertarAlFinal(decodificado);
     
     // Mostrar información de debug
-    std::cout << "Fragmento '" << caracter << "' decodificado como '" 
-              << decodificado << "'. Mensaje: [";
-    carga->imprimirMensaje();
-    std::cout << "]" << std::endl;
+    reportar(caracter, decodificado, carga);
+}
+
+void TramaLoad::reportar(char original, char decodificado, ListaDeCarga* carga) {
+    ModoSalida modo = getModoSalida();
+    if (modo == SALIDA_SILENCIOSA) return;
+    
+    std::cout << "Fragmento '" << original << "' decodificado como '" 
+              << decodificado << "'.";
+    
+    // Reimprimir el mensaje completo cuesta O(n) por trama: solo en depuración
+    if (modo == SALIDA_COMPLETA) {
+        std::cout << " Mensaje: [";
+        carga->imprimirMensaje();
+        std::cout << "]";
+    }
+    std::cout << std::endl;
 }
\ No newline at end of file
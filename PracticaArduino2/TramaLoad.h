@@ -46,6 +46,27 @@ public:
      * 2. Inserta el resultado en la lista de carga
      */
     void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor);
+    
+    /**
+     * @brief Obtiene el carácter sin decodificar de la trama
+     * @return Carácter tal como llegó en la trama
+     */
+    char getCaracter() const { return caracter; }
+    
+    /**
+     * @brief Muestra el diagnóstico de un fragmento ya insertado en la lista
+     * @param original Carácter recibido en la trama
+     * @param decodificado Carácter insertado tras pasar por el rotor
+     * @param carga Lista con el mensaje ensamblado hasta el momento
+     * 
+     * Lo usan procesar() y Decodificador::reportarLote(), que con
+     * diagnóstico por carga traduce la racha en bloque y luego reporta cada
+     * fragmento. Decodificador no construye TramaLoad: procesar() queda
+     * para quien procese una carga suelta, y ambos caminos producen la
+     * misma salida. Respeta el modo de salida: solo SALIDA_COMPLETA vuelve
+     * a imprimir el mensaje entero.
+     */
+    static void reportar(char original, char decodificado, ListaDeCarga* carga);
 };
 
 #endif // TRAMA_LOAD_H
\ No newline at end of file
@@ -0,0 +1,18 @@
+/**
+ * @file TramaLote.cpp
+ * @brief Implementación de la clase TramaLote
+ */
+
+#include "TramaLote.h"
+
+void TramaLote::procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
+    // Por tramos, para no reservar memoria con rachas largas
+    const int TAM_TRAMO = 256;
+    char decodificados[TAM_TRAMO];
+    
+    for (int i = 0; i < numCargas; i += TAM_TRAMO) {
+        int n = numCargas - i < TAM_TRAMO ? numCargas - i : TAM_TRAMO;
+        rotor->mapearBloque(cargas + i, decodificados, (size_t)n);
+        carga->insertarBloque(decodificados, n);
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file TramaLote.h
+ * @brief Clase derivada que agrupa una racha de tramas de carga consecutivas
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef TRAMA_LOTE_H
+#define TRAMA_LOTE_H
+
+#include "TramaBase.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+
+/**
+ * @class TramaLote
+ * @brief Varias tramas L,X seguidas, procesadas como una sola
+ * 
+ * No llega por el puerto: Decodificador la construye con las cargas que se
+ * acumulan entre dos tramas de otro tipo. Entre ellas el rotor no cambia,
+ * así que todas se traducen con RotorDeMapeo::mapearBloque() y se anexan
+ * con ListaDeCarga::insertarBloque(): una llamada virtual por racha en
+ * lugar de una por carga.
+ * 
+ * No imprime diagnósticos; con diagnóstico por carga Decodificador procesa
+ * la racha fragmento a fragmento.
+ */
+class TramaLote : public TramaBase {
+private:
+    const char* cargas;     ///< Caracteres sin decodificar (no se copian)
+    int numCargas;          ///< Caracteres en 'cargas'
+    
+public:
+    /**
+     * @brief Constructor
+     * @param c Caracteres tal como llegaron; deben seguir vivos al procesar
+     * @param n Número de caracteres
+     */
+    TramaLote(const char* c, int n) : cargas(c), numCargas(n) {}
+    
+    /**
+     * @brief Destructor (usa el de la clase base)
+     */
+    ~TramaLote() {}
+    
+    /**
+     * @brief Procesa la trama: mapea todas las cargas y las anexa en bloque
+     * @param carga Lista donde se insertan los caracteres decodificados
+     * @param rotor Rotor usado para mapearlos
+     */
+    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor);
+    
+    /**
+     * @brief Obtiene el número de cargas agrupadas
+     * @return Caracteres de la racha
+     */
+    int getNumCargas() const { return numCargas; }
+};
+
+#endif // TRAMA_LOTE_H
@@ -11,6 +11,8 @@ void TramaMap::procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
     rotor->rotar(rotacion);
     
     // Mostrar información de debug
+    if (getModoSalida() == SALIDA_SILENCIOSA) return;
+    
     std::cout << "ROTANDO ROTOR ";
     if (rotacion > 0) {
         std::cout << "+" << rotacion;
@@ -0,0 +1,231 @@
+/**
+ * @file TuberiaSerial.cpp
+ * @brief Implementación de la tubería lector / decodificador / salida
+ */
+
+#include "TuberiaSerial.h"
+#include "ColaSPSC.h"
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <thread>
+
+namespace {
+
+/**
+ * @struct LineaCapturada
+ * @brief Copia de una línea del puerto en tránsito hacia el decodificador
+ */
+struct LineaCapturada {
+    unsigned long long offset;              ///< Posición de la línea en el flujo
+    long long llegada;                      ///< relojNs() de la lectura del puerto
+    size_t longitud;                        ///< Bytes usados de 'texto'
+    char texto[SerialReader::MAX_LINEA];    ///< Línea sin terminador
+};
+
+/**
+ * @struct BloqueSalida
+ * @brief Texto ya formateado en tránsito hacia el hilo de salida
+ */
+struct BloqueSalida {
+    static const size_t TAM = 4096;     ///< Capacidad de 'texto'
+    size_t longitud;                    ///< Bytes usados de 'texto'
+    char texto[TAM];                    ///< Salida de std::cout
+};
+
+typedef ColaSPSC<LineaCapturada, 1024> ColaLineas;
+typedef ColaSPSC<BloqueSalida, 256> ColaSalida;
+
+/**
+ * @struct EstadoLector
+ * @brief Datos compartidos entre el hilo lector y el decodificador
+ */
+struct EstadoLector {
+    SerialReader* serial;               ///< Puerto (solo lo toca el lector)
+    int esperaMs;                       ///< Espera máxima sin datos
+    ColaLineas* lineas;                 ///< Cola lector -> decodificador (se cierra al terminar)
+};
+
+/**
+ * @brief Cuerpo del hilo lector
+ * @param estado Estado compartido con el decodificador
+ */
+void hiloLector(EstadoLector* estado) {
+    const char* linea;
+    size_t longitud;
+    unsigned long long offset;
+
+    for (;;) {
+        while (estado->serial->siguienteLinea(linea, longitud, offset)) {
+            // La vista de siguienteLinea() caduca en la próxima llamada:
+            // se copia ya a la casilla
+            LineaCapturada* casilla = estado->lineas->esperarReserva();
+
+            casilla->offset = offset;
+            casilla->llegada = estado->serial->getInstanteLinea();
+            casilla->longitud = longitud;
+            std::memcpy(casilla->texto, linea, longitud);
+            estado->lineas->publicar();
+        }
+
+        // Sin líneas completas: el decodificador ya no espera por este hilo
+        estado->lineas->setProductorActivo(false);
+        int r = estado->serial->esperarDatos(estado->esperaMs);
+        if (r < 0) break;
+        if (r > 0) estado->lineas->setProductorActivo(true);
+    }
+
+    estado->lineas->cerrar();
+}
+
+/**
+ * @class SalidaEncolada
+ * @brief streambuf que entrega lo escrito en std::cout a una ColaSalida
+ *
+ * Cada bloque se publica al llenarse o al vaciar el flujo (std::endl,
+ * flush), de modo que el hilo de salida escribe en el mismo orden y con la
+ * misma granularidad que lo haría std::cout.
+ */
+class SalidaEncolada : public std::streambuf {
+    ColaSalida& cola;       ///< Cola hacia el hilo de salida
+    BloqueSalida* actual;   ///< Casilla que se está rellenando, o 0
+
+    /**
+     * @brief Publica la casilla actual si tiene texto
+     */
+    void entregar() {
+        if (actual && pptr() > pbase()) {
+            actual->longitud = (size_t)(pptr() - pbase());
+            cola.publicar();
+            actual = 0;
+            setp(0, 0);
+        }
+    }
+
+protected:
+    int_type overflow(int_type c) {
+        entregar();
+        if (!actual) {
+            actual = cola.esperarReserva();
+            setp(actual->texto, actual->texto + BloqueSalida::TAM);
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() {
+        entregar();
+        return 0;
+    }
+
+public:
+    explicit SalidaEncolada(ColaSalida& c) : cola(c), actual(0) {}
+};
+
+/**
+ * @brief Cuerpo del hilo de salida
+ * @param cola Cola decodificador -> salida; termina cuando se cierra
+ * @param destino streambuf original de std::cout
+ */
+void hiloSalida(ColaSalida* cola, std::streambuf* destino) {
+    for (;;) {
+        BloqueSalida* bloque = cola->frente();
+        if (bloque) {
+            destino->sputn(bloque->texto, (std::streamsize)bloque->longitud);
+            cola->liberar();
+            continue;
+        }
+
+        // Sin bloques pendientes: sacar lo escrito antes de dormir
+        destino->pubsync();
+        bloque = cola->esperarFrente(-1);
+        if (!bloque) break;
+    }
+}
+
+/**
+ * @brief Imprime los contadores de presión de una cola
+ * @param nombre Descripción de la cola
+ * @param cola Cola a reportar
+ */
+template <class Cola>
+void reportarCola(const char* nombre, const Cola& cola) {
+    std::cerr << "Tuberia [" << nombre << "]: publicadas " << cola.getPublicadas()
+              << ", llena " << cola.getVecesLlena()
+              << ", vacia " << cola.getVecesVacia()
+              << ", ocupacion maxima " << cola.getOcupacionMaxima()
+              << "/" << cola.capacidad() << std::endl;
+}
+
+} // namespace
+
+void decodificarEnTuberia(SerialReader& serial, int etapas, int esperaMs,
+                          Decodificador& decodificador,
+                          void (*alQuedarseSinLineas)(Decodificador&)) {
+    ColaLineas* lineas = new ColaLineas;
+
+    EstadoLector estado;
+    estado.serial = &serial;
+    estado.esperaMs = esperaMs;
+    estado.lineas = lineas;
+
+    // Tercera etapa: std::cout pasa a escribir en la cola de salida
+    ColaSalida* salida = 0;
+    SalidaEncolada* salidaEncolada = 0;
+    std::streambuf* original = 0;
+    std::thread escritor;
+    if (etapas >= 3) {
+        salida = new ColaSalida;
+        salidaEncolada = new SalidaEncolada(*salida);
+        original = std::cout.rdbuf(salidaEncolada);
+        escritor = std::thread(hiloSalida, salida, original);
+    }
+
+    std::thread lector(hiloLector, &estado);
+
+    // Este hilo es el decodificador; duerme en la cola como mucho 'esperaMs'
+    // para atender las señales igual que sin tubería
+    bool pendienteDeVaciar = false;
+    for (;;) {
+        LineaCapturada* linea = lineas->frente();
+        if (linea) {
+            if (salida && !pendienteDeVaciar) salida->setProductorActivo(true);
+            decodificador.marcarLlegada(linea->llegada);
+            decodificador.procesarLinea(linea->texto, linea->longitud, linea->offset);
+            lineas->liberar();
+            pendienteDeVaciar = true;
+            continue;
+        }
+
+        // No quedan líneas: no retener el lote ni la salida
+        if (pendienteDeVaciar) {
+            decodificador.vaciarLote();
+            std::cout.flush();
+            pendienteDeVaciar = false;
+            if (salida) salida->setProductorActivo(false);
+        }
+        if (alQuedarseSinLineas) alQuedarseSinLineas(decodificador);
+
+        if (lineas->terminada()) break;
+        lineas->esperarFrente(esperaMs);
+    }
+
+    lector.join();
+
+    if (salida) {
+        std::cout.flush();
+        salida->cerrar();
+        escritor.join();
+        std::cout.rdbuf(original);
+    }
+
+    reportarCola("lector -> decodificador", *lineas);
+    if (salida) reportarCola("decodificador -> salida", *salida);
+
+    delete salidaEncolada;
+    delete salida;
+    delete lineas;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file TuberiaSerial.h
+ * @brief Lectura, decodificación y salida del puerto en hilos separados
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ */
+
+#ifndef TUBERIA_SERIAL_H
+#define TUBERIA_SERIAL_H
+
+#include "SerialReader.h"
+#include "Decodificador.h"
+
+/**
+ * @brief Decodifica el puerto con una tubería de dos o tres etapas
+ * @param serial Puerto ya conectado; solo lo usa el hilo lector
+ * @param etapas 2 = hilo lector + decodificación; 3 = además un hilo de salida
+ * @param esperaMs Espera máxima sin datos del hilo lector y del decodificador
+ * @param decodificador Sesión; solo la usa el hilo que llama a esta función
+ * @param alQuedarseSinLineas Se llama en el hilo decodificador cada vez que
+ *        no hay líneas pendientes (para atender SIGUSR1); puede ser 0
+ *
+ * El hilo lector copia cada línea del SerialReader a una ColaSPSC y vuelve
+ * enseguida al puerto, así que un std::cout lento ya no detiene la lectura
+ * ni provoca desbordes del buffer del sistema. Con tres etapas, std::cout se
+ * redirige a una segunda cola que vacía un hilo de salida.
+ *
+ * Cada hilo sin trabajo duerme en su cola hasta que el anterior publica,
+ * sin sondeos periódicos que añadan latencia a cada trama.
+ *
+ * Al terminar imprime en std::cerr los contadores de presión de cada cola:
+ * cuántas veces el productor esperó con la cola llena y el consumidor con
+ * la cola vacía mientras el productor tenía datos en curso.
+ */
+void decodificarEnTuberia(SerialReader& serial, int etapas, int esperaMs,
+                          Decodificador& decodificador,
+                          void (*alQuedarseSinLineas)(Decodificador&));
+
+#endif // TUBERIA_SERIAL_H
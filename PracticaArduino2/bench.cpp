@@ -0,0 +1,438 @@
+/**
+ * @file bench.cpp
+ * @brief Mediciones de rendimiento del decodificador (objetivo "bench" de CMake)
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ *
+ * Genera un flujo PRT-7 sintético y reproducible con GeneradorTramas y mide
+ * por separado las piezas del camino caliente y el procesamiento completo,
+ * en ns por operación y operaciones por segundo. Cada medición se repite y
+ * se informa la mejor, para que la comparación entre versiones no dependa
+ * del ruido de la máquina.
+ *
+ * --generar escribe el flujo en la salida estándar en lugar de medir; con
+ * --binario lo escribe codificado en PRT-7B.
+ *
+ * Uso: bench [--tramas N] [--mapeo P] [--rotacion pequena|uniforme|extrema]
+ *            [--mensaje L] [--semilla S] [--generar [--binario]]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include "GeneradorTramas.h"
+#include "RotorDeMapeo.h"
+#include "Alfabetos.h"
+#include "ListaDeCarga.h"
+#include "BuscadorPalabras.h"
+#include "ParserTramas.h"
+#include "ProtocoloBinario.h"
+#include "Decodificador.h"
+#include "TramaBase.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Reloj;
+
+/// Veces que se repite cada medición (se informa la mejor)
+const int REPETICIONES = 5;
+
+/// Acumula resultados para que el compilador no descarte el trabajo medido
+volatile unsigned long long resultadoMedido = 0;
+
+/**
+ * @class ColectorTramas
+ * @brief Receptor que guarda las cargas y rotaciones del flujo generado
+ */
+class ColectorTramas : public ReceptorTramas {
+public:
+    char* cargas;           ///< Caracteres de las tramas LOAD, sin decodificar
+    int* rotaciones;        ///< Valores de las tramas MAP
+    size_t numCargas;       ///< Cargas guardadas
+    size_t numRotaciones;   ///< Rotaciones guardadas
+    size_t tramas;          ///< Líneas válidas vistas
+
+    explicit ColectorTramas(size_t capacidad)
+        : cargas(new char[capacidad]), rotaciones(new int[capacidad]),
+          numCargas(0), numRotaciones(0), tramas(0) {}
+
+    ~ColectorTramas() {
+        delete[] cargas;
+        delete[] rotaciones;
+    }
+
+    void alRecibirTrama(const TramaParseada& trama, const char* linea,
+                        size_t longitud, unsigned long long offset) {
+        (void)linea; (void)longitud; (void)offset;
+        tramas++;
+        if (trama.tipo == TRAMA_CARGA) cargas[numCargas++] = trama.caracter;
+        if (trama.tipo == TRAMA_MAPEO) rotaciones[numRotaciones++] = trama.rotacion;
+    }
+
+    void alErrorParseo(ErrorParseo error, const char* linea,
+                       size_t longitud, unsigned long long offset) {
+        (void)error; (void)linea; (void)longitud; (void)offset;
+    }
+};
+
+/**
+ * @class ContadorTramas
+ * @brief Receptor mínimo: solo cuenta, para medir el parser aislado
+ */
+class ContadorTramas : public ReceptorTramas {
+public:
+    unsigned long long tramas;  ///< Líneas recibidas (válidas o no)
+
+    ContadorTramas() : tramas(0) {}
+
+    void alRecibirTrama(const TramaParseada& trama, const char* linea,
+                        size_t longitud, unsigned long long offset) {
+        (void)trama; (void)linea; (void)longitud; (void)offset;
+        tramas++;
+    }
+
+    void alErrorParseo(ErrorParseo error, const char* linea,
+                       size_t longitud, unsigned long long offset) {
+        (void)error; (void)linea; (void)longitud; (void)offset;
+        tramas++;
+    }
+};
+
+/**
+ * @brief Segundos transcurridos desde 'inicio'
+ */
+double segundosDesde(Reloj::time_point inicio) {
+    return std::chrono::duration<double>(Reloj::now() - inicio).count();
+}
+
+/**
+ * @brief Imprime una fila de resultados
+ * @param nombre Qué se midió
+ * @param operaciones Operaciones por repetición
+ * @param segundos Mejor tiempo de una repetición
+ * @param unidad Nombre de la operación (ej. "trama", "car")
+ */
+void reportar(const char* nombre, unsigned long long operaciones, double segundos,
+              const char* unidad) {
+    double ns = segundos * 1e9 / (double)operaciones;
+    double porSegundo = (double)operaciones / segundos;
+
+    std::cout << std::left << std::setw(38) << nombre << std::right
+              << std::setw(12) << operaciones << " "
+              << std::fixed << std::setprecision(2) << std::setw(10) << ns
+              << " ns/" << std::left << std::setw(6) << unidad << std::right
+              << std::setprecision(0) << std::setw(14) << porSegundo
+              << " " << unidad << "/s" << std::endl;
+}
+
+/**
+ * @brief Interpreta los argumentos del bench
+ * @return true si son válidos
+ */
+bool parsearArgumentos(int argc, char* argv[], ConfiguracionGenerador& config,
+                       size_t& tramas, bool& soloGenerar, bool& binario) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--generar") == 0) {
+            soloGenerar = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--binario") == 0) {
+            binario = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Falta el valor de la opcion " << arg << std::endl;
+            return false;
+        }
+        const char* valor = argv[++i];
+
+        if (std::strcmp(arg, "--tramas") == 0) {
+            long n = std::atol(valor);
+            if (n <= 0) {
+                std::cerr << "Error: --tramas debe ser positivo: " << valor << std::endl;
+                return false;
+            }
+            tramas = (size_t)n;
+        } else if (std::strcmp(arg, "--mapeo") == 0) {
+            config.porcentajeMapeo = std::atoi(valor);
+            if (config.porcentajeMapeo < 0 || config.porcentajeMapeo > 100) {
+                std::cerr << "Error: --mapeo es un porcentaje (0-100): " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--rotacion") == 0) {
+            if (std::strcmp(valor, "pequena") == 0) {
+                config.distribucion = ROTACION_PEQUENA;
+            } else if (std::strcmp(valor, "uniforme") == 0) {
+                config.distribucion = ROTACION_UNIFORME;
+            } else if (std::strcmp(valor, "extrema") == 0) {
+                config.distribucion = ROTACION_EXTREMA;
+            } else {
+                std::cerr << "Error: Distribucion desconocida: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--mensaje") == 0) {
+            config.longitudMensaje = std::atoi(valor);
+            if (config.longitudMensaje < 0) {
+                std::cerr << "Error: --mensaje no puede ser negativo: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--semilla") == 0) {
+            config.semilla = std::strtoull(valor, 0, 10);
+        } else {
+            std::cerr << "Error: Opcion desconocida: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (binario && !soloGenerar) {
+        std::cerr << "Error: --binario solo se admite con --generar" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ConfiguracionGenerador config;
+    size_t numTramas = 2000000;
+    bool soloGenerar = false;
+    bool binario = false;
+    if (!parsearArgumentos(argc, argv, config, numTramas, soloGenerar, binario)) {
+        std::cerr << "Uso: " << argv[0] << " [--tramas N] [--mapeo P] "
+                  << "[--rotacion pequena|uniforme|extrema] [--mensaje L] "
+                  << "[--semilla S] [--generar [--binario]]" << std::endl;
+        return 1;
+    }
+
+    // Flujo de prueba en memoria
+    GeneradorTramas generador(config);
+    char* flujo = new char[numTramas * GeneradorTramas::MAX_TRAMA];
+    size_t bytes = 0;
+    for (size_t i = 0; i < numTramas; i++) bytes += generador.siguiente(flujo + bytes);
+
+    // El mismo flujo en PRT-7B
+    char* flujoBinario = new char[2 * bytes + MAX_TRAMA_BINARIA];
+    size_t bytesBinarios = convertirABinario(flujo, bytes, flujoBinario, 0);
+
+    // --generar: solo escribir el flujo (para --input o un transmisor)
+    if (soloGenerar) {
+        if (binario) {
+            std::cout.write(flujoBinario, (std::streamsize)bytesBinarios);
+        } else {
+            std::cout.write(flujo, (std::streamsize)bytes);
+        }
+        delete[] flujoBinario;
+        delete[] flujo;
+        return 0;
+    }
+
+    ColectorTramas datos(numTramas);
+    tokenizarTramas(flujo, bytes, 0, datos, true);
+
+    std::cout << "Bench PRT-7: " << numTramas << " tramas, " << bytes << " bytes, "
+              << config.porcentajeMapeo << "% MAP, semilla " << config.semilla << std::endl;
+    std::cout << "En PRT-7B: " << bytesBinarios << " bytes" << std::endl;
+#ifndef NDEBUG
+    std::cout << "Aviso: compilado sin NDEBUG; use -DCMAKE_BUILD_TYPE=Release para medir" << std::endl;
+#endif
+    std::cout << std::endl;
+
+    TramaBase::setModoSalida(SALIDA_SILENCIOSA);
+    char* salida = new char[datos.numCargas + 1];
+    double mejor;
+
+    // RotorDeMapeo::getMapeo, un carácter a la vez
+    {
+        RotorDeMapeo rotor;
+        rotor.rotar(5);
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            Reloj::time_point inicio = Reloj::now();
+            unsigned long long acumulado = 0;
+            for (size_t i = 0; i < datos.numCargas; i++) {
+                acumulado += (unsigned char)rotor.getMapeo(datos.cargas[i]);
+            }
+            double t = segundosDesde(inicio);
+            resultadoMedido += acumulado;
+            if (t < mejor) mejor = t;
+        }
+        reportar("RotorDeMapeo::getMapeo", datos.numCargas, mejor, "car");
+    }
+
+    // RotorFijo: mismo alfabeto resuelto al compilar (suma y ajuste)
+    {
+        RotorFijo<AlfabetoPrt7> rotor;
+        rotor.rotar(5);
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            Reloj::time_point inicio = Reloj::now();
+            unsigned long long acumulado = 0;
+            for (size_t i = 0; i < datos.numCargas; i++) {
+                acumulado += (unsigned char)rotor.getMapeo(datos.cargas[i]);
+            }
+            double t = segundosDesde(inicio);
+            resultadoMedido += acumulado;
+            if (t < mejor) mejor = t;
+        }
+        reportar("RotorFijo<AlfabetoPrt7>::getMapeo", datos.numCargas, mejor, "car");
+    }
+
+    // RotorDeMapeo::mapearBloque, el mismo trabajo por bloques
+    {
+        RotorDeMapeo rotor;
+        rotor.rotar(5);
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            Reloj::time_point inicio = Reloj::now();
+            rotor.mapearBloque(datos.cargas, salida, datos.numCargas);
+            double t = segundosDesde(inicio);
+            resultadoMedido += (unsigned char)salida[datos.numCargas / 2];
+            if (t < mejor) mejor = t;
+        }
+        reportar("RotorDeMapeo::mapearBloque", datos.numCargas, mejor, "car");
+    }
+
+    // Alfabeto de 256 símbolos: sin kernel vectorial, usa RotorFijo<AlfabetoBytes>
+    {
+        const char* simbolos;
+        int longitud;
+        RotorDeMapeo::buscarAlfabeto("bytes", simbolos, longitud);
+        RotorDeMapeo rotor(simbolos, longitud);
+        rotor.rotar(5);
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            Reloj::time_point inicio = Reloj::now();
+            rotor.mapearBloque(datos.cargas, salida, datos.numCargas);
+            double t = segundosDesde(inicio);
+            resultadoMedido += (unsigned char)salida[datos.numCargas / 2];
+            if (t < mejor) mejor = t;
+        }
+        reportar("RotorDeMapeo::mapearBloque (bytes)", datos.numCargas, mejor, "car");
+    }
+
+    // RotorDeMapeo::rotar
+    if (datos.numRotaciones > 0) {
+        RotorDeMapeo rotor;
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            Reloj::time_point inicio = Reloj::now();
+            for (size_t i = 0; i < datos.numRotaciones; i++) rotor.rotar(datos.rotaciones[i]);
+            double t = segundosDesde(inicio);
+            resultadoMedido += (unsigned long long)rotor.getDesplazamiento();
+            if (t < mejor) mejor = t;
+        }
+        reportar("RotorDeMapeo::rotar", datos.numRotaciones, mejor, "rot");
+    }
+
+    // ListaDeCarga::insertarAlFinal con nodos de 1 y de 64 caracteres
+    const int capacidades[] = { 1, 64 };
+    for (int c = 0; c < 2; c++) {
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            ListaDeCarga lista(capacidades[c]);
+            Reloj::time_point inicio = Reloj::now();
+            for (size_t i = 0; i < datos.numCargas; i++) lista.insertarAlFinal(datos.cargas[i]);
+            double t = segundosDesde(inicio);
+            resultadoMedido += (unsigned long long)lista.getTamanio();
+            if (t < mejor) mejor = t;
+        }
+        reportar(capacidades[c] == 1 ? "ListaDeCarga::insertarAlFinal (1)"
+                                     : "ListaDeCarga::insertarAlFinal (64)",
+                 datos.numCargas, mejor, "car");
+    }
+
+    // ListaDeCarga::obtenerCaracter en posiciones al azar (nodos de 1 carácter)
+    if (datos.numCargas > 0) {
+        ListaDeCarga lista(1);
+        lista.insertarBloque(datos.cargas, (int)datos.numCargas);
+        char c;
+        lista.obtenerCaracter(0, c);    // el índice se construye fuera de la medición
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            unsigned long long posicion = 12345;
+            unsigned long long acumulado = 0;
+            Reloj::time_point inicio = Reloj::now();
+            for (size_t i = 0; i < datos.numCargas; i++) {
+                posicion = (posicion * 6364136223846793005ULL + 1442695040888963407ULL);
+                lista.obtenerCaracter((posicion >> 16) % datos.numCargas, c);
+                acumulado += (unsigned char)c;
+            }
+            double t = segundosDesde(inicio);
+            resultadoMedido += acumulado;
+            if (t < mejor) mejor = t;
+        }
+        reportar("ListaDeCarga::obtenerCaracter", datos.numCargas, mejor, "car");
+    }
+
+    // BuscadorPalabras::procesar con un puñado de palabras
+    {
+        const char* palabras[] = { "HOLA", "MUNDO", "ARDUINO", "PRT", "A B", "ZZ" };
+        BuscadorPalabras buscador;
+        for (int p = 0; p < 6; p++) buscador.agregarPalabra(palabras[p], std::strlen(palabras[p]));
+        buscador.compilar();
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            buscador.reiniciar();
+            Reloj::time_point inicio = Reloj::now();
+            buscador.procesar(datos.cargas, datos.numCargas, 0);
+            double t = segundosDesde(inicio);
+            if (t < mejor) mejor = t;
+        }
+        resultadoMedido += buscador.getCoincidencias();
+        reportar("BuscadorPalabras::procesar", datos.numCargas, mejor, "car");
+    }
+
+    // Parser (parsearLinea vía tokenizarTramas, sin decodificar)
+    {
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            ContadorTramas contador;
+            Reloj::time_point inicio = Reloj::now();
+            tokenizarTramas(flujo, bytes, 0, contador, true);
+            double t = segundosDesde(inicio);
+            resultadoMedido += contador.tramas;
+            if (t < mejor) mejor = t;
+        }
+        reportar("tokenizarTramas + parsearLinea", numTramas, mejor, "trama");
+    }
+
+    // Parser binario (cada carga de un bloque cuenta como una trama)
+    {
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            ContadorTramas contador;
+            Reloj::time_point inicio = Reloj::now();
+            tokenizarTramasBinarias(flujoBinario, bytesBinarios, 0, contador, true);
+            double t = segundosDesde(inicio);
+            resultadoMedido += contador.tramas;
+            if (t < mejor) mejor = t;
+        }
+        reportar("tokenizarTramasBinarias", numTramas, mejor, "trama");
+    }
+
+    // Extremo a extremo: parseo, lotes, rotor y lista (modo silencioso)
+    const int bloques[] = { 1, 64 };
+    for (int c = 0; c < 2; c++) {
+        mejor = 1e30;
+        for (int r = 0; r < REPETICIONES; r++) {
+            Decodificador decodificador(bloques[c]);
+            Reloj::time_point inicio = Reloj::now();
+            tokenizarTramas(flujo, bytes, 0, decodificador, true);
+            decodificador.vaciarLote();
+            double t = segundosDesde(inicio);
+            resultadoMedido += (unsigned long long)decodificador.getLista().getTamanio();
+            if (t < mejor) mejor = t;
+        }
+        reportar(bloques[c] == 1 ? "Decodificador extremo a extremo (1)"
+                                 : "Decodificador extremo a extremo (64)",
+                 numTramas, mejor, "trama");
+    }
+
+    delete[] salida;
+    delete[] flujoBinario;
+    delete[] flujo;
+    return 0;
+}
@@ -6,183 +6,417 @@
  * 
  * Este programa lee tramas del puerto serial conectado a un Arduino,
  * procesa las instrucciones de carga y mapeo, y ensambla el mensaje oculto.
+ * También puede decodificar offline una captura guardada (--input).
  */
 
 #include <iostream>
-#include <cstdlib>  // Para atoi
+#include <csignal>
+#include <cstring>
 #include "SerialReader.h"
-#include "ListaDeCarga.h"
-#include "RotorDeMapeo.h"
+#include "ArchivoMapeado.h"
+#include "Decodificador.h"
+#include "DecodificadorParalelo.h"
+#include "TuberiaSerial.h"
+#include "SesionesMultiples.h"
+#include "SumideroCarga.h"
+#include "BuscadorPalabras.h"
+#include "ParserTramas.h"
+#include "ProtocoloBinario.h"
 #include "TramaBase.h"
-#include "TramaLoad.h"
-#include "TramaMap.h"
+#include "Opciones.h"
+#include "Metricas.h"
+#include "Instantanea.h"
 
-#ifdef _WIN32
-    #include <windows.h>
-    #define SLEEP(ms) Sleep(ms)
-#else
-    #include <unistd.h>
-    #define SLEEP(ms) usleep((ms) * 1000)
-#endif
+/// Se activa desde el manejador de señal para pedir el mensaje acumulado
+volatile std::sig_atomic_t mensajeSolicitado = 0;
 
 /**
- * @brief Parsea una línea de texto y crea la trama correspondiente
- * @param linea Cadena con formato "L,X" o "M,N"
- * @return Puntero a TramaBase (TramaLoad o TramaMap) o NULL si hay error
+ * @brief Manejador de SIGUSR1: solo marca la petición
+ * @param senal Número de señal recibida (no se usa)
  * 
- * Ejemplo: "L,H" -> TramaLoad('H')
- *          "M,2" -> TramaMap(2)
+ * La impresión se hace en el bucle principal, fuera del contexto de señal.
+ */
+void solicitarMensaje(int senal) {
+    (void)senal;
+    mensajeSolicitado = 1;
+}
+
+/**
+ * @brief Atiende una petición pendiente de SIGUSR1, si la hay
+ * @param decodificador Sesión cuyo mensaje se imprime
+ */
+void atenderSolicitudMensaje(Decodificador& decodificador) {
+    if (!mensajeSolicitado) return;
+    
+    mensajeSolicitado = 0;
+    std::cout << "[Mensaje parcial: ";
+    decodificador.imprimirMensaje();
+    std::cout << "]" << std::endl;
+}
+
+/// Destino y calendario de los volcados de métricas (inactivo sin --metricas)
+PublicadorMetricas publicadorMetricas;
+
+/**
+ * @brief Vuelca las métricas si llegó SIGUSR2 o se cumplió el intervalo
+ * @param decodificador Sesión cuyas métricas se vuelcan
+ */
+void atenderMetricas(Decodificador& decodificador) {
+    if (!publicadorMetricas.pendiente()) return;
+    
+    publicadorMetricas.publicar(*decodificador.getMetricas());
+    publicadorMetricas.terminarRonda();
+}
+
+/// Instantáneas para reanudar tras un reinicio (inactivo sin --instantanea)
+GestorInstantaneas gestorInstantaneas;
+
+/// Sumidero en archivo de la sesión, que cada instantánea sincroniza (o 0)
+SumideroDescriptor* sumideroInstantanea = 0;
+
+/**
+ * @brief Toma una instantánea si se cumplió el intervalo
+ * @param decodificador Sesión a guardar
+ * @param offset Bytes del flujo ya entregados a la sesión
+ * @param forzar true para tomarla sin mirar el intervalo (fin del flujo)
+ */
+void atenderInstantanea(Decodificador& decodificador, unsigned long long offset, bool forzar) {
+    if (!gestorInstantaneas.activo()) return;
+    if (forzar || gestorInstantaneas.pendiente()) {
+        gestorInstantaneas.guardar(decodificador, offset, sumideroInstantanea);
+    }
+}
+
+/**
+ * @brief Atiende las peticiones pendientes (mensaje parcial y métricas)
+ * @param decodificador Sesión afectada
+ */
+void atenderSolicitudes(Decodificador& decodificador) {
+    atenderSolicitudMensaje(decodificador);
+    atenderMetricas(decodificador);
+}
+
+/**
+ * @brief Sumidero "-": el mensaje sale por std::cout, en orden con los diagnósticos
+ * @param datos Caracteres del mensaje, o 0 al terminar un mensaje
+ * @param n Número de caracteres
+ * @param contexto No se usa
+ */
+void escribirEnConsola(const char* datos, size_t n, void* contexto) {
+    (void)contexto;
+    if (datos) {
+        std::cout.write(datos, (std::streamsize)n);
+    } else {
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * @brief Decodifica las tramas que llegan por el puerto serial
+ * @param opciones Opciones de la línea de comandos
+ * @param decodificador Sesión donde se ensambla el mensaje
+ * @param base Bytes decodificados antes de reanudar (para las instantáneas)
+ * @return 0 si terminó normalmente, 1 si no se pudo conectar
  */
-TramaBase* parsearTrama(char* linea) {
-    // Verificar que la línea no esté vacía
-    if (linea[0] == '\0') return 0;
+int decodificarPuerto(const Opciones& opciones, Decodificador& decodificador,
+                      unsigned long long base) {
+    // Solicitar puerto al usuario si no se indicó con --puerto
+    char nombrePuerto[50];
+    const char* puerto = opciones.numPuertos > 0 ? opciones.puertos[0] : 0;
+    if (puerto) {
+        std::cout << "Puerto serial: " << puerto << std::endl;
+    } else {
+        std::cout << "Ingrese el puerto serial (ej. COM3 o /dev/ttyUSB0): ";
+        std::cin.getline(nombrePuerto, 50);
+    }
+    
+    // Crear el lector serial
+    SerialReader serial(puerto ? puerto : nombrePuerto, opciones.serial);
+    
+    std::cout << std::endl;
+    std::cout << "Iniciando Decodificador PRT-7. Conectando a puerto..." << std::endl;
     
-    // Primer carácter: tipo de trama
-    char tipo = linea[0];
+    if (!serial.conectar()) {
+        std::cerr << "Error: No se pudo conectar al puerto serial" << std::endl;
+        std::cerr << "Verifique que:" << std::endl;
+        std::cerr << "  1. El Arduino este conectado" << std::endl;
+        std::cerr << "  2. El nombre del puerto sea correcto" << std::endl;
+        std::cerr << "  3. No haya otra aplicacion usando el puerto" << std::endl;
+        return 1;
+    }
     
-    // Debe haber una coma
-    if (linea[1] != ',') {
-        std::cerr << "Error: Formato invalido (falta coma)" << std::endl;
+    std::cout << "Conexion establecida. Esperando tramas..." << std::endl;
+    std::cout << std::endl;
+    
+    // Lectura y decodificación en hilos separados
+    if (opciones.etapas > 1) {
+        decodificarEnTuberia(serial, opciones.etapas, opciones.esperaMs,
+                             decodificador, atenderSolicitudes);
+        serial.cerrar();
         return 0;
     }
     
-    // El dato está después de la coma
-    char* dato = &linea[2];
+    // Vista de la línea actual dentro del buffer del lector (sin copias)
+    const char* linea;
+    size_t longitud;
+    unsigned long long offset;
     
-    if (tipo == 'L') {
-        // Trama de carga: L,X
-        if (dato[0] == '\0') {
-            std::cerr << "Error: Trama LOAD sin caracter" << std::endl;
-            return 0;
+    // Bucle principal: esperar datos y procesar todas las tramas disponibles.
+    // Solo termina cuando el flujo se cierra; cada FIN cierra un mensaje.
+    while (true) {
+        while (serial.siguienteLinea(linea, longitud, offset)) {
+            decodificador.marcarLlegada(serial.getInstanteLinea());
+            decodificador.procesarLinea(linea, longitud, offset);
         }
         
-        // Manejar el caso especial del espacio: "L,Space" o "L, "
-        char caracter = dato[0];
-        if (dato[0] == 'S' && dato[1] == 'p' && dato[2] == 'a' && 
-            dato[3] == 'c' && dato[4] == 'e') {
-            caracter = ' ';
-        }
+        // No quedan líneas completas: no retener el lote
+        decodificador.vaciarLote();
         
-        return new TramaLoad(caracter);
-    } 
-    else if (tipo == 'M') {
-        // Trama de mapeo: M,N
-        if (dato[0] == '\0') {
-            std::cerr << "Error: Trama MAP sin valor" << std::endl;
+        // Mensaje acumulado (SIGUSR1) y métricas (SIGUSR2) bajo demanda
+        atenderSolicitudes(decodificador);
+        atenderInstantanea(decodificador, base + serial.getConsumidos(), false);
+        
+        // Dormir hasta que lleguen bytes (o expire la espera para revisar señales)
+        if (serial.esperarDatos(opciones.esperaMs) < 0) break;
+    }
+    
+    atenderInstantanea(decodificador, base + serial.getConsumidos(), true);
+    serial.cerrar();
+    return 0;
+}
+
+/**
+ * @brief Decodifica una captura guardada en archivo
+ * @param opciones Opciones de la línea de comandos (usa 'entrada')
+ * @param decodificador Sesión donde se ensambla el mensaje
+ * @param desde Bytes ya decodificados según la instantánea (0 = desde el inicio)
+ * @return 0 si terminó normalmente, 1 si no se pudo abrir el archivo o
+ *         la instantánea no corresponde a la captura
+ * 
+ * El archivo se proyecta en memoria y se tokeniza en una sola pasada
+ * directamente desde la proyección, sin copiar líneas. Los CR/LF se tratan
+ * igual que en SerialReader: las líneas vacías se ignoran. Con --hilos la
+ * captura se reparte entre varios hilos (ver decodificarEnParalelo()).
+ * Las capturas PRT-7B se recorren con tokenizarTramasBinarias().
+ */
+int decodificarArchivo(const Opciones& opciones, Decodificador& decodificador,
+                       unsigned long long desde) {
+    std::cout << "Decodificando captura " << opciones.entrada << "..." << std::endl;
+    
+    ArchivoMapeado archivo;
+    if (!archivo.abrir(opciones.entrada)) {
+        std::cerr << "Error: No se pudo leer la captura" << std::endl;
+        return 1;
+    }
+    
+    std::cout << std::endl;
+    
+    const char* datos = archivo.getDatos();
+    size_t total = archivo.getTamanio();
+    size_t procesados = 0;
+    
+    // Formato: el indicado o, en automático, el del primer byte que no sea CR/LF
+    bool binario = opciones.serial.formato == FORMATO_BINARIO;
+    if (opciones.serial.formato == FORMATO_AUTO) {
+        size_t i = 0;
+        while (i < total && (datos[i] == '\n' || datos[i] == '\r')) i++;
+        binario = i < total && (unsigned char)datos[i] == SYNC_BINARIO;
+    }
+    size_t (*tokenizar)(const char*, size_t, unsigned long long, ReceptorTramas&, bool) =
+        binario ? tokenizarTramasBinarias : tokenizarTramas;
+    
+    // Reanudar: la instantánea debe caer en un límite de trama de esta captura
+    if (desde > 0) {
+        bool limite = desde == total ||
+            (desde < total && (binario ? (unsigned char)datos[desde] == SYNC_BINARIO ||
+                                         datos[desde] == '\n' || datos[desde] == '\r'
+                                       : datos[desde - 1] == '\n' || datos[desde - 1] == '\r'));
+        if (desde > total || !limite) {
+            std::cerr << "Error: La instantanea no corresponde a " << opciones.entrada << std::endl;
+            return 1;
+        }
+        std::cout << "Reanudando en el byte " << desde << " de " << total << std::endl;
+        procesados = (size_t)desde;
+    }
+    
+    if (opciones.hilos != 1) {
+        if (!binario) {
+            decodificarEnParalelo(datos, total, opciones.hilos, decodificador);
             return 0;
         }
+        // Los tramos paralelos se cortan en fines de línea
+        std::cerr << "Aviso: --hilos solo reparte capturas de texto; se usa un hilo" << std::endl;
+    }
+    
+    // Se tokeniza por tramos grandes para poder atender SIGUSR1 entre ellos.
+    // Con instantáneas una última línea sin terminador no se decodifica:
+    // la captura puede estar cortada a media trama y la instantánea debe
+    // quedar en un límite de línea para poder reanudar sobre la completa.
+    const size_t TRAMO = 1 << 20;
+    bool cerrarAlFinal = !gestorInstantaneas.activo();
+    while (procesados < total) {
+        size_t disponible = total - procesados;
+        bool ultimo = disponible <= TRAMO;
+        size_t tramo = ultimo ? disponible : TRAMO;
         
-        // Convertir a entero manualmente (sin atoi para mayor control)
-        int num = 0;
-        int signo = 1;
-        int i = 0;
+        size_t consumidos = tokenizar(datos + procesados, tramo, procesados,
+                                      decodificador, ultimo && cerrarAlFinal);
         
-        // Verificar signo
-        if (dato[i] == '-') {
-            signo = -1;
-            i++;
-        } else if (dato[i] == '+') {
-            i++;
+        // Una sola línea más larga que el tramo: entregarla completa
+        if (consumidos == 0 && !ultimo) {
+            consumidos = tokenizar(datos + procesados, disponible, procesados,
+                                   decodificador, cerrarAlFinal);
         }
+        procesados += consumidos;
         
-        // Convertir dígitos
-        while (dato[i] >= '0' && dato[i] <= '9') {
-            num = num * 10 + (dato[i] - '0');
-            i++;
-        }
+        atenderSolicitudes(decodificador);
+        atenderInstantanea(decodificador, procesados, false);
         
-        num *= signo;
-        return new TramaMap(num);
+        // Solo queda una trama incompleta
+        if (consumidos == 0) break;
     }
     
-    std::cerr << "Error: Tipo de trama desconocido: " << tipo << std::endl;
+    if (procesados < total) {
+        std::cerr << "Aviso: Los ultimos " << (total - procesados) << " bytes no forman una trama"
+                  << " completa; se procesaran al reanudar con la captura completa" << std::endl;
+    }
+    
+    decodificador.vaciarLote();
+    atenderInstantanea(decodificador, procesados, true);
     return 0;
 }
 
 /**
  * @brief Función principal del programa
  */
-int main() {
-    std::cout << "==================================================" << std::endl;
-    std::cout << "  DECODIFICADOR PRT-7 - Sistema de Ciberseguridad" << std::endl;
-    std::cout << "==================================================" << std::endl;
-    std::cout << std::endl;
+int main(int argc, char* argv[]) {
+    Opciones opciones;
+    if (!parsearOpciones(argc, argv, opciones)) {
+        mostrarAyuda(argv[0]);
+        return 1;
+    }
+    TramaBase::setModoSalida(opciones.modo);
     
-    // Solicitar puerto al usuario
-    std::cout << "Ingrese el puerto serial (ej. COM3 o /dev/ttyUSB0): ";
-    char nombrePuerto[50];
-    std::cin.getline(nombrePuerto, 50);
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, solicitarMensaje);
+#endif
     
-    // Crear el lector serial
-    SerialReader serial(nombrePuerto);
+    // Métricas: SIGUSR2 pide un volcado
+    if (opciones.metricas) {
+        if (!publicadorMetricas.abrir(opciones.metricas, opciones.intervaloMetricas)) return 1;
+#ifdef SIGUSR2
+        std::signal(SIGUSR2, PublicadorMetricas::solicitar);
+#endif
+    }
     
+    std::cout << "==================================================" << std::endl;
+    std::cout << "  DECODIFICADOR PRT-7 - Sistema de Ciberseguridad" << std::endl;
+    std::cout << "==================================================" << std::endl;
     std::cout << std::endl;
-    std::cout << "Iniciando Decodificador PRT-7. Conectando a puerto..." << std::endl;
     
-    if (!serial.conectar()) {
-        std::cerr << "Error: No se pudo conectar al puerto serial" << std::endl;
-        std::cerr << "Verifique que:" << std::endl;
-        std::cerr << "  1. El Arduino este conectado" << std::endl;
-        std::cerr << "  2. El nombre del puerto sea correcto" << std::endl;
-        std::cerr << "  3. No haya otra aplicacion usando el puerto" << std::endl;
-        return 1;
+    // Varios transmisores: cada uno con su propia sesión
+    if (opciones.numPuertos > 1) {
+        return decodificarSesiones(opciones, mensajeSolicitado,
+                                   opciones.metricas ? &publicadorMetricas : 0);
     }
     
-    std::cout << "Conexion establecida. Esperando tramas..." << std::endl;
-    std::cout << std::endl;
-    
     // Inicializar estructuras de datos
-    ListaDeCarga miLista;
-    RotorDeMapeo miRotor;
+    Decodificador decodificador(opciones.capacidadBloque, opciones.alfabeto,
+                                opciones.longitudAlfabeto);
+    decodificador.setReiniciarRotorEnFin(opciones.reiniciarRotor);
+    Metricas metricas;
+    if (opciones.metricas) decodificador.setMetricas(&metricas);
     
-    // Buffer para leer líneas
-    char buffer[100];
-    int tramasRecibidas = 0;
+    // Instantánea previa: se lee antes de abrir el sumidero, que debe
+    // conservar lo que ya se escribió
+    int reanudar = 0;
+    if (opciones.instantanea) {
+        gestorInstantaneas.abrir(opciones.instantanea, opciones.intervaloInstantanea);
+        reanudar = gestorInstantaneas.cargar();
+        if (reanudar < 0) return 1;
+    }
+    const Instantanea& previa = gestorInstantaneas.getEstado();
+    if (reanudar) {
+        TipoSumideroInstantanea tipo = !opciones.sumidero ? INSTANTANEA_SIN_SUMIDERO
+            : std::strcmp(opciones.sumidero, "-") == 0 ? INSTANTANEA_CONSOLA : INSTANTANEA_ARCHIVO;
+        if (tipo != previa.sumidero) {
+            std::cerr << "Error: La instantanea se tomo con otro --sumidero" << std::endl;
+            return 1;
+        }
+    }
     
-    // Bucle principal: leer y procesar tramas
-    while (true) {
-        if (serial.leerLinea(buffer, 100)) {
-            tramasRecibidas++;
-            
-            std::cout << "Trama recibida: [" << buffer << "] -> Procesando... -> ";
-            
-            // Parsear la trama
-            TramaBase* trama = parsearTrama(buffer);
-            
-            if (trama) {
-                // Ejecutar el procesamiento polimórfico
-                trama->procesar(&miLista, &miRotor);
-                
-                // Liberar memoria de la trama
-                delete trama;
-            } else {
-                std::cout << "Error al parsear trama" << std::endl;
-            }
-            
-            std::cout << std::endl;
+    // Modo streaming: el mensaje sale por bloques y solo se retiene el final
+    SumideroDescriptor archivoSalida;
+    SumideroFuncion consola(escribirEnConsola);
+    SumideroCarga* sumidero = 0;
+    if (opciones.sumidero) {
+        if (std::strcmp(opciones.sumidero, "-") == 0) {
+            sumidero = &consola;
+        } else if (reanudar ? archivoSalida.reabrir(opciones.sumidero, previa.bytesSumidero)
+                            : archivoSalida.abrir(opciones.sumidero)) {
+            sumidero = &archivoSalida;
+            sumideroInstantanea = &archivoSalida;
+        } else {
+            return 1;
         }
-        
-        // Pequeña pausa para no saturar el CPU
-        SLEEP(100);
-        
-        // Salir después de recibir muchas tramas (para no quedarse colgado)
-        // En producción, esto sería una señal de fin de transmisión
-        if (tramasRecibidas >= 50) {
-            std::cout << "[Limite de tramas alcanzado, finalizando...]" << std::endl;
-            break;
+        decodificador.getLista().setSumidero(sumidero, opciones.ventana);
+    }
+    
+    // Rotor, mensaje a medias y contadores de la sesión anterior
+    if (reanudar) {
+        if (!gestorInstantaneas.restaurar(decodificador)) return 1;
+        std::cout << "Instantanea " << opciones.instantanea << ": " << previa.mensajesCompletos
+                  << " mensajes completos, " << decodificador.getLista().getLongitudMensaje()
+                  << " caracteres del mensaje en curso" << std::endl;
+    }
+    
+    // Palabras vigiladas: se buscan a medida que se anexa el mensaje
+    AvisoCoincidencias avisos;
+    BuscadorPalabras buscador(&avisos);
+    if (opciones.numVigiladas > 0) {
+        for (int i = 0; i < opciones.numVigiladas; i++) {
+            buscador.agregarPalabra(opciones.vigiladas[i], std::strlen(opciones.vigiladas[i]));
         }
+        buscador.compilar();
+        decodificador.getLista().setBuscador(&buscador);
     }
     
-    // Mostrar resultado final
+    int resultado = opciones.entrada
+        ? decodificarArchivo(opciones, decodificador, reanudar ? previa.offset : 0)
+        : decodificarPuerto(opciones, decodificador, reanudar ? previa.offset : 0);
+    if (resultado != 0) return resultado;
+    
+    // Mostrar resultado final: el mensaje sin FIN que haya quedado abierto
     std::cout << std::endl;
     std::cout << "---" << std::endl;
     std::cout << "Flujo de datos terminado." << std::endl;
-    std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
-    miLista.imprimirMensaje();
-    std::cout << std::endl;
+    decodificador.vaciarLote();
+    ListaDeCarga& lista = decodificador.getLista();
+    if (sumidero) {
+        // Entregar también el mensaje que quedó sin FIN
+        if (!lista.estaVacia() || lista.getVolcados() > 0) lista.cerrarMensaje();
+        sumidero->vaciar();
+        std::cout << "Mensaje entregado a " << opciones.sumidero << std::endl;
+    } else if (decodificador.getMensajesCompletos() == 0 || !lista.estaVacia()) {
+        std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
+        decodificador.imprimirMensaje();
+        std::cout << std::endl;
+    }
+    if (decodificador.getMensajesCompletos() > 0) {
+        std::cout << "Mensajes completos: " << decodificador.getMensajesCompletos() << std::endl;
+    }
+    if (opciones.numVigiladas > 0) {
+        std::cout << "Coincidencias: " << buscador.getCoincidencias() << std::endl;
+    }
     std::cout << "---" << std::endl;
+    
+    // Último volcado de métricas, con el flujo completo
+    if (opciones.metricas) {
+        publicadorMetricas.publicar(metricas);
+        publicadorMetricas.terminarRonda();
+    }
+    
     std::cout << "Liberando memoria... Sistema apagado." << std::endl;
     
-    serial.cerrar();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,633 @@
+/**
+ * @file transmisor.cpp
+ * @brief Transmisor PRT-7 sobre una pseudo-terminal, para probar sin Arduino
+ * @author Juan Francisco Ortega Pulido
+ * @date 2025
+ *
+ * Crea un par maestro/esclavo de pseudo-terminal y escribe tramas en el
+ * maestro. El decodificador se conecta al esclavo con --puerto exactamente
+ * igual que a un Arduino, así que se recorre el camino real de la tty
+ * (disciplina de línea, termios, poll) en una máquina sin hardware.
+ *
+ * Fuentes de tramas:
+ * - Por defecto, la misma secuencia que envía arduino_transmitter.ino.
+ * - --archivo F: las líneas de una captura.
+ * - --generar N: N tramas de GeneradorTramas (--mapeo, --mensaje, --semilla).
+ *
+ * --tasa T limita a T tramas por segundo (0 = sin límite; 1 reproduce el
+ * ritmo del sketch). Al terminar se informa la tasa lograda, el retraso
+ * máximo respecto al plan y cuántas veces el lector no dio abasto: si el
+ * retraso crece con una tasa fija, esa tasa no es sostenible.
+ *
+ * --binario envía la secuencia codificada en PRT-7B (ver ProtocoloBinario.h);
+ * entonces --tasa cuenta tramas binarias (bloques, rachas, mapeos y FIN).
+ *
+ * --sonda no espera a un lector externo: el propio transmisor abre el
+ * esclavo con SerialReader y mide la latencia de cada trama (escritura en
+ * el maestro hasta que siguienteLinea() la entrega).
+ *
+ * Solo para Linux/Mac (posix_openpt).
+ *
+ * Uso: transmisor [--archivo F | --generar N] [--repetir K] [--tasa T]
+ *                 [--enlace RUTA] [--mapeo P] [--mensaje L] [--semilla S]
+ *                 [--espera-final MS] [--sonda] [--binario]
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+#include "GeneradorTramas.h"
+#include "ProtocoloBinario.h"
+#include "SerialReader.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Reloj;
+
+/// Tramas como máximo por escritura en modo sin límite
+const size_t LOTE_MAXIMO = 1024;
+
+/// Margen tras conectarse el lector, que vacía la tty al configurarla
+const int RETARDO_CONEXION_MS = 200;
+
+/// Secuencia de arduino_transmitter.ino
+const char* const TRAMAS_ARDUINO[] = {
+    "L,H", "L,O", "L,L", "M,2", "L,A", "L,Space",
+    "L,W", "M,-2", "L,O", "L,R", "L,L", "L,D", "FIN"
+};
+const size_t NUM_TRAMAS_ARDUINO = sizeof(TRAMAS_ARDUINO) / sizeof(TRAMAS_ARDUINO[0]);
+
+/// Se pone a 1 con Ctrl+C
+volatile std::sig_atomic_t detener = 0;
+
+void solicitarDetencion(int) {
+    detener = 1;
+}
+
+/**
+ * @struct OpcionesTransmisor
+ * @brief Argumentos del transmisor
+ */
+struct OpcionesTransmisor {
+    const char* archivo;            ///< Captura a reproducir (0 = secuencia del sketch)
+    long generar;                   ///< Tramas sintéticas (0 = no generar)
+    long repeticiones;              ///< Veces que se envía la secuencia
+    double tasa;                    ///< Tramas por segundo (0 = sin límite)
+    const char* enlace;             ///< Enlace simbólico al esclavo (0 = ninguno)
+    int esperaFinalMs;              ///< Espera antes de cerrar, para que el lector vacíe
+    bool sonda;                     ///< Medir latencia con un SerialReader propio
+    bool binario;                   ///< Enviar tramas PRT-7B en lugar de texto
+    ConfiguracionGenerador generador;   ///< Parámetros de --generar
+
+    OpcionesTransmisor()
+        : archivo(0), generar(0), repeticiones(1), tasa(0.0), enlace(0),
+          esperaFinalMs(1000), sonda(false), binario(false) {}
+};
+
+/**
+ * @struct SecuenciaTramas
+ * @brief Todas las líneas de una repetición, contiguas y terminadas en "\r\n"
+ *
+ * La trama i ocupa datos[inicios[i]] .. datos[inicios[i + 1]], así que
+ * varias tramas seguidas se envían con una sola escritura.
+ */
+struct SecuenciaTramas {
+    char* datos;        ///< Bytes de todas las tramas
+    size_t* inicios;    ///< numTramas + 1 posiciones
+    size_t numTramas;   ///< Tramas en la secuencia
+
+    SecuenciaTramas() : datos(0), inicios(0), numTramas(0) {}
+
+    ~SecuenciaTramas() {
+        delete[] datos;
+        delete[] inicios;
+    }
+
+    /**
+     * @brief Reserva espacio para 'tramas' líneas y 'bytes' bytes
+     */
+    void reservar(size_t tramas, size_t bytes) {
+        datos = new char[bytes > 0 ? bytes : 1];
+        inicios = new size_t[tramas + 1];
+        inicios[0] = 0;
+        numTramas = 0;
+    }
+
+    /**
+     * @brief Añade una línea (sin terminador) con "\r\n" como Serial.println()
+     */
+    void agregar(const char* linea, size_t longitud) {
+        size_t p = inicios[numTramas];
+        std::memcpy(datos + p, linea, longitud);
+        p += longitud;
+        datos[p++] = '\r';
+        datos[p++] = '\n';
+        inicios[++numTramas] = p;
+    }
+
+    size_t bytes() const { return inicios[numTramas]; }
+};
+
+double segundosDesde(Reloj::time_point inicio) {
+    return std::chrono::duration<double>(Reloj::now() - inicio).count();
+}
+
+/**
+ * @brief Carga las líneas no vacías de una captura
+ * @return false si no se pudo leer o no tiene tramas
+ */
+bool cargarArchivo(const char* ruta, SecuenciaTramas& secuencia) {
+    std::FILE* f = std::fopen(ruta, "rb");
+    if (!f) {
+        std::cerr << "Error: No se pudo abrir " << ruta << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::fseek(f, 0, SEEK_END);
+    long tamanio = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    if (tamanio < 0) tamanio = 0;
+
+    char* contenido = new char[(size_t)tamanio + 1];
+    size_t leidos = std::fread(contenido, 1, (size_t)tamanio, f);
+    std::fclose(f);
+
+    // Cada línea crece como mucho en un byte al normalizar a "\r\n"
+    secuencia.reservar(leidos / 2 + 1, 2 * leidos + 2);
+    size_t i = 0;
+    while (i < leidos) {
+        size_t fin = i;
+        while (fin < leidos && contenido[fin] != '\n' && contenido[fin] != '\r') fin++;
+        if (fin > i) secuencia.agregar(contenido + i, fin - i);
+        i = fin + 1;
+    }
+    delete[] contenido;
+
+    if (secuencia.numTramas == 0) {
+        std::cerr << "Error: " << ruta << " no contiene tramas" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Prepara la secuencia a enviar según las opciones
+ */
+bool prepararSecuencia(const OpcionesTransmisor& opciones, SecuenciaTramas& secuencia) {
+    if (opciones.archivo) return cargarArchivo(opciones.archivo, secuencia);
+
+    if (opciones.generar > 0) {
+        ConfiguracionGenerador config = opciones.generador;
+        config.finDeLineaCRLF = false;
+        GeneradorTramas generador(config);
+
+        secuencia.reservar((size_t)opciones.generar,
+                           (size_t)opciones.generar * (GeneradorTramas::MAX_TRAMA + 1));
+        char linea[GeneradorTramas::MAX_TRAMA];
+        for (long i = 0; i < opciones.generar; i++) {
+            size_t n = generador.siguiente(linea);
+            secuencia.agregar(linea, n - 1);
+        }
+        return true;
+    }
+
+    secuencia.reservar(NUM_TRAMAS_ARDUINO, NUM_TRAMAS_ARDUINO * 16);
+    for (size_t i = 0; i < NUM_TRAMAS_ARDUINO; i++) {
+        secuencia.agregar(TRAMAS_ARDUINO[i], std::strlen(TRAMAS_ARDUINO[i]));
+    }
+    return true;
+}
+
+/**
+ * @brief Reemplaza la secuencia de texto por su equivalente PRT-7B
+ * @return false si no queda ninguna trama
+ *
+ * Cada trama binaria pasa a ser una trama de la secuencia; se delimitan
+ * recorriéndolas con decodificarTramaBinaria().
+ */
+bool convertirSecuencia(SecuenciaTramas& secuencia) {
+    size_t bytesTexto = secuencia.bytes();
+    char* binario = new char[2 * bytesTexto + MAX_TRAMA_BINARIA];
+    unsigned long long descartadas = 0;
+    size_t n = convertirABinario(secuencia.datos, bytesTexto, binario, &descartadas);
+    if (descartadas > 0) {
+        std::cerr << "Aviso: " << descartadas << " lineas invalidas no se envian en binario" << std::endl;
+    }
+
+    delete[] secuencia.datos;
+    delete[] secuencia.inicios;
+    secuencia.datos = binario;
+    // La trama binaria más corta (FIN) ocupa 3 bytes
+    secuencia.inicios = new size_t[n / 3 + 1];
+    secuencia.inicios[0] = 0;
+    secuencia.numTramas = 0;
+
+    size_t p = 0;
+    while (p < n) {
+        TramaBinaria trama;
+        long longitud = decodificarTramaBinaria(binario + p, n - p, trama);
+        if (longitud <= 0) break;
+        p += (size_t)longitud;
+        secuencia.inicios[++secuencia.numTramas] = p;
+    }
+
+    if (secuencia.numTramas == 0) {
+        std::cerr << "Error: La secuencia no contiene tramas validas" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Crea la pseudo-terminal y deja el esclavo en modo crudo
+ * @param ruta Recibe la ruta del esclavo (ej. "/dev/pts/3")
+ * @return Descriptor del maestro, o -1 si falla
+ *
+ * El esclavo se abre y se cierra una vez: así queda configurado y, mientras
+ * nadie lo tenga abierto, poll() sobre el maestro informa POLLHUP, que es
+ * como se detecta que el lector se conectó o se fue.
+ */
+int abrirPseudoTerminal(char* ruta, size_t capacidad) {
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0) {
+        std::cerr << "Error: No se pudo crear la pseudo-terminal: " << std::strerror(errno) << std::endl;
+        if (maestro >= 0) close(maestro);
+        return -1;
+    }
+
+    const char* nombre = ptsname(maestro);
+    if (!nombre || std::strlen(nombre) >= capacidad) {
+        std::cerr << "Error: Ruta de la pseudo-terminal no disponible" << std::endl;
+        close(maestro);
+        return -1;
+    }
+    std::strcpy(ruta, nombre);
+
+    int esclavo = open(ruta, O_RDWR | O_NOCTTY);
+    if (esclavo >= 0) {
+        struct termios modo;
+        if (tcgetattr(esclavo, &modo) == 0) {
+            cfmakeraw(&modo);
+            tcsetattr(esclavo, TCSANOW, &modo);
+        }
+        close(esclavo);
+    }
+
+    fcntl(maestro, F_SETFL, fcntl(maestro, F_GETFL) | O_NONBLOCK);
+    return maestro;
+}
+
+/**
+ * @brief true si nadie tiene abierto el esclavo
+ */
+bool lectorAusente(int maestro) {
+    struct pollfd pfd;
+    pfd.fd = maestro;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLHUP);
+}
+
+/**
+ * @brief Descarta lo que el lector escriba de vuelta (ej. eco si no es crudo)
+ */
+void descartarEntrada(int maestro) {
+    char basura[256];
+    while (read(maestro, basura, sizeof(basura)) > 0) {}
+}
+
+/**
+ * @brief Escribe todo el bloque en el maestro, esperando al lector si se llena
+ * @param bloqueos Se incrementa cada vez que el lector no dio abasto
+ * @return false si el lector cerró o se pidió detener
+ */
+bool escribirTodo(int maestro, const char* datos, size_t n, unsigned long long& bloqueos) {
+    while (n > 0) {
+        ssize_t r = write(maestro, datos, n);
+        if (r > 0) {
+            datos += r;
+            n -= (size_t)r;
+            continue;
+        }
+        if (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            if (errno != EIO) {
+                std::cerr << "Error: Escritura en la pseudo-terminal: " << std::strerror(errno) << std::endl;
+            }
+            return false;
+        }
+
+        // La tty del lector está llena: esperar a que consuma
+        bloqueos++;
+        struct pollfd pfd;
+        pfd.fd = maestro;
+        pfd.events = POLLOUT | POLLIN;
+        pfd.revents = 0;
+        while (!detener) {
+            int listo = poll(&pfd, 1, 200);
+            if (listo > 0 && (pfd.revents & POLLHUP)) return false;
+            if (listo > 0 && (pfd.revents & POLLIN)) descartarEntrada(maestro);
+            if (listo > 0 && (pfd.revents & POLLOUT)) break;
+        }
+        if (detener) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Envía la secuencia al lector externo respetando la tasa
+ * @return Código de salida del programa
+ */
+int transmitir(int maestro, const SecuenciaTramas& secuencia, const OpcionesTransmisor& opciones) {
+    const unsigned long long total = (unsigned long long)secuencia.numTramas *
+                                     (unsigned long long)opciones.repeticiones;
+    unsigned long long enviadas = 0;
+    unsigned long long bytes = 0;
+    unsigned long long bloqueos = 0;
+    double retrasoMaximo = 0.0;
+    bool lectorPresente = true;
+
+    Reloj::time_point inicio = Reloj::now();
+    while (enviadas < total && !detener) {
+        // Tramas que según el plan ya deberían haber salido
+        unsigned long long tocan = total;
+        if (opciones.tasa > 0.0) {
+            double transcurrido = segundosDesde(inicio);
+            tocan = (unsigned long long)(transcurrido * opciones.tasa) + 1;
+            if (tocan > total) tocan = total;
+            if (tocan <= enviadas) {
+                std::this_thread::sleep_for(std::chrono::duration<double>(
+                    (double)enviadas / opciones.tasa - transcurrido));
+                continue;
+            }
+            double retraso = transcurrido - (double)enviadas / opciones.tasa;
+            if (retraso > retrasoMaximo) retrasoMaximo = retraso;
+        }
+
+        // Lote contiguo dentro de una repetición
+        size_t desde = (size_t)(enviadas % secuencia.numTramas);
+        size_t hasta = secuencia.numTramas;
+        if (hasta - desde > LOTE_MAXIMO) hasta = desde + LOTE_MAXIMO;
+        if (hasta - desde > tocan - enviadas) hasta = desde + (size_t)(tocan - enviadas);
+
+        size_t n = secuencia.inicios[hasta] - secuencia.inicios[desde];
+        if (!escribirTodo(maestro, secuencia.datos + secuencia.inicios[desde], n, bloqueos)) {
+            lectorPresente = !detener && !lectorAusente(maestro);
+            break;
+        }
+        enviadas += hasta - desde;
+        bytes += n;
+    }
+    double duracion = segundosDesde(inicio);
+
+    // Dar tiempo al lector a vaciar la tty antes de colgar
+    for (int ms = 0; ms < opciones.esperaFinalMs && lectorPresente && !detener; ms += 50) {
+        if (lectorAusente(maestro)) break;
+        descartarEntrada(maestro);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    std::cout << "Transmisor: " << enviadas << " de " << total << " tramas ("
+              << bytes << " bytes) en " << std::fixed << std::setprecision(3)
+              << duracion << " s" << std::endl;
+    if (!lectorPresente) std::cout << "El lector cerro el puerto antes de terminar" << std::endl;
+    std::cout << "Tasa lograda: " << std::setprecision(0)
+              << (duracion > 0.0 ? (double)enviadas / duracion : 0.0) << " tramas/s";
+    if (opciones.tasa > 0.0) {
+        std::cout << " (objetivo " << std::setprecision(1) << opciones.tasa << ")" << std::endl;
+        std::cout << "Retraso maximo respecto al plan: " << std::setprecision(3)
+                  << retrasoMaximo * 1000.0 << " ms" << std::endl;
+    } else {
+        std::cout << " (sin limite)" << std::endl;
+    }
+    std::cout << "Esperas por lector lento: " << bloqueos << std::endl;
+
+    return enviadas == total ? 0 : 1;
+}
+
+/**
+ * @brief Envía la secuencia a un SerialReader propio y mide la latencia
+ * @return Código de salida del programa
+ *
+ * Se envía una trama a la vez y se espera a recibirla (ida simple por la
+ * tty), así que la tasa lograda es la de una trama en vuelo.
+ */
+int sondear(int maestro, const char* ruta, const SecuenciaTramas& secuencia,
+            const OpcionesTransmisor& opciones) {
+    SerialReader lector(ruta);
+    if (!lector.conectar()) return 1;
+
+    const unsigned long long total = (unsigned long long)secuencia.numTramas *
+                                     (unsigned long long)opciones.repeticiones;
+    double* latencias = new double[total > 0 ? total : 1];
+    unsigned long long enviadas = 0;
+    unsigned long long distintas = 0;
+    unsigned long long bloqueos = 0;
+
+    Reloj::time_point inicio = Reloj::now();
+    while (enviadas < total && !detener) {
+        if (opciones.tasa > 0.0) {
+            double falta = (double)enviadas / opciones.tasa - segundosDesde(inicio);
+            if (falta > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(falta));
+        }
+
+        size_t i = (size_t)(enviadas % secuencia.numTramas);
+        const char* trama = secuencia.datos + secuencia.inicios[i];
+        size_t n = secuencia.inicios[i + 1] - secuencia.inicios[i];
+
+        Reloj::time_point envio = Reloj::now();
+        if (!escribirTodo(maestro, trama, n, bloqueos)) break;
+
+        const char* linea = 0;
+        size_t longitud = 0;
+        unsigned long long offset = 0;
+        bool recibida = false;
+        while (!recibida && !detener) {
+            if (lector.siguienteLinea(linea, longitud, offset)) {
+                recibida = true;
+            } else if (lector.esperarDatos(1000) < 0) {
+                break;
+            }
+        }
+        if (!recibida) break;
+
+        latencias[enviadas++] = segundosDesde(envio);
+        if (longitud != n - 2 || std::memcmp(linea, trama, longitud) != 0) distintas++;
+    }
+    double duracion = segundosDesde(inicio);
+
+    std::cout << "Sonda: " << enviadas << " de " << total << " tramas en "
+              << std::fixed << std::setprecision(3) << duracion << " s";
+    if (duracion > 0.0) {
+        std::cout << " (" << std::setprecision(0) << (double)enviadas / duracion << " tramas/s)";
+    }
+    std::cout << std::endl;
+
+    if (enviadas > 0) {
+        double suma = 0.0;
+        for (unsigned long long k = 0; k < enviadas; k++) suma += latencias[k];
+        std::sort(latencias, latencias + enviadas);
+
+        std::cout << std::setprecision(1)
+                  << "Latencia (us): min " << latencias[0] * 1e6
+                  << ", media " << suma / (double)enviadas * 1e6
+                  << ", p50 " << latencias[enviadas / 2] * 1e6
+                  << ", p99 " << latencias[(enviadas * 99) / 100] * 1e6
+                  << ", max " << latencias[enviadas - 1] * 1e6 << std::endl;
+    }
+    if (distintas > 0) std::cout << "Lineas recibidas distintas de las enviadas: " << distintas << std::endl;
+
+    delete[] latencias;
+    return (enviadas == total && distintas == 0) ? 0 : 1;
+}
+
+/**
+ * @brief Interpreta los argumentos
+ * @return true si son válidos
+ */
+bool parsearArgumentos(int argc, char* argv[], OpcionesTransmisor& opciones) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--sonda") == 0) {
+            opciones.sonda = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--binario") == 0) {
+            opciones.binario = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Falta el valor de la opcion " << arg << std::endl;
+            return false;
+        }
+        const char* valor = argv[++i];
+
+        if (std::strcmp(arg, "--archivo") == 0) {
+            opciones.archivo = valor;
+        } else if (std::strcmp(arg, "--generar") == 0) {
+            opciones.generar = std::atol(valor);
+            if (opciones.generar <= 0) {
+                std::cerr << "Error: --generar debe ser positivo: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--repetir") == 0) {
+            opciones.repeticiones = std::atol(valor);
+            if (opciones.repeticiones <= 0) {
+                std::cerr << "Error: --repetir debe ser positivo: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--tasa") == 0) {
+            opciones.tasa = std::atof(valor);
+            if (opciones.tasa < 0.0) {
+                std::cerr << "Error: --tasa no puede ser negativa: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--enlace") == 0) {
+            opciones.enlace = valor;
+        } else if (std::strcmp(arg, "--espera-final") == 0) {
+            opciones.esperaFinalMs = std::atoi(valor);
+            if (opciones.esperaFinalMs < 0) {
+                std::cerr << "Error: --espera-final no puede ser negativa: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--mapeo") == 0) {
+            opciones.generador.porcentajeMapeo = std::atoi(valor);
+            if (opciones.generador.porcentajeMapeo < 0 || opciones.generador.porcentajeMapeo > 100) {
+                std::cerr << "Error: --mapeo es un porcentaje (0-100): " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--mensaje") == 0) {
+            opciones.generador.longitudMensaje = std::atoi(valor);
+            if (opciones.generador.longitudMensaje < 0) {
+                std::cerr << "Error: --mensaje no puede ser negativo: " << valor << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(arg, "--semilla") == 0) {
+            opciones.generador.semilla = std::strtoull(valor, 0, 10);
+        } else {
+            std::cerr << "Error: Opcion desconocida: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (opciones.archivo && opciones.generar > 0) {
+        std::cerr << "Error: --archivo y --generar son excluyentes" << std::endl;
+        return false;
+    }
+    // La sonda compara cada línea recibida con la trama enviada
+    if (opciones.sonda && opciones.binario) {
+        std::cerr << "Error: --sonda no se admite con --binario" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    OpcionesTransmisor opciones;
+    if (!parsearArgumentos(argc, argv, opciones)) {
+        std::cerr << "Uso: " << argv[0] << " [--archivo F | --generar N] [--repetir K] "
+                  << "[--tasa T] [--enlace RUTA] [--mapeo P] [--mensaje L] [--semilla S] "
+                  << "[--espera-final MS] [--sonda] [--binario]" << std::endl;
+        return 1;
+    }
+
+    SecuenciaTramas secuencia;
+    if (!prepararSecuencia(opciones, secuencia)) return 1;
+    if (opciones.binario && !convertirSecuencia(secuencia)) return 1;
+
+    char ruta[256];
+    int maestro = abrirPseudoTerminal(ruta, sizeof(ruta));
+    if (maestro < 0) return 1;
+
+    std::signal(SIGINT, solicitarDetencion);
+    std::signal(SIGTERM, solicitarDetencion);
+
+    if (opciones.enlace) {
+        // Solo se reemplaza un enlace anterior, nunca un archivo normal
+        struct stat previo;
+        if (lstat(opciones.enlace, &previo) == 0 && S_ISLNK(previo.st_mode)) unlink(opciones.enlace);
+        if (symlink(ruta, opciones.enlace) != 0) {
+            std::cerr << "Error: No se pudo crear el enlace " << opciones.enlace
+                      << ": " << std::strerror(errno) << std::endl;
+            close(maestro);
+            return 1;
+        }
+    }
+
+    std::cout << "Pseudo-terminal: " << ruta << std::endl;
+    std::cout << "Secuencia: " << secuencia.numTramas << " tramas x "
+              << opciones.repeticiones << std::endl;
+
+    int resultado = 1;
+    if (opciones.sonda) {
+        resultado = sondear(maestro, ruta, secuencia, opciones);
+    } else {
+        std::cout << "Esperando lector en " << (opciones.enlace ? opciones.enlace : ruta)
+                  << " (ej. decodificador --puerto " << (opciones.enlace ? opciones.enlace : ruta)
+                  << ")" << std::endl;
+        while (!detener && lectorAusente(maestro)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (!detener) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(RETARDO_CONEXION_MS));
+            std::cout << "Lector conectado, transmitiendo..." << std::endl;
+            resultado = transmitir(maestro, secuencia, opciones);
+        }
+    }
+
+    if (opciones.enlace) unlink(opciones.enlace);
+    close(maestro);
+    return resultado;
+}